@@ -17,6 +17,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
 #include <vector>
 
@@ -46,4 +48,68 @@ double calculate_stddev(const container & vec)
   return std::sqrt(sq_sum);
 }
 
+// Latency distribution of nonnegative samples in nanoseconds, with 8 linear buckets per power
+// of two: every sample is counted in a bucket no wider than 1/8 of its value.
+class rttest_latency_histogram
+{
+public:
+  static constexpr size_t sub_buckets = 8;
+
+  rttest_latency_histogram()
+  : buckets(bucket_index(UINT64_MAX) + 1, 0)
+  {}
+
+  void add(uint64_t sample)
+  {
+    ++this->buckets[bucket_index(sample)];
+    if (this->count == 0 || sample < this->min) {
+      this->min = sample;
+    }
+    if (sample > this->max) {
+      this->max = sample;
+    }
+    ++this->count;
+  }
+
+  // Upper bound of the bucket holding the given fraction of the samples
+  uint64_t percentile(double fraction) const
+  {
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * this->count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < this->buckets.size(); ++i) {
+      seen += this->buckets[i];
+      if (seen >= rank && seen > 0) {
+        return std::min(bucket_upper_bound(i), this->max);
+      }
+    }
+    return this->max;
+  }
+
+  uint64_t count = 0;
+  uint64_t min = 0;
+  uint64_t max = 0;
+
+private:
+  static size_t bucket_index(uint64_t sample)
+  {
+    if (sample < sub_buckets) {
+      return sample;
+    }
+    size_t msb = 63 - __builtin_clzll(sample);
+    return (msb - 2) * sub_buckets + ((sample >> (msb - 3)) & (sub_buckets - 1));
+  }
+
+  static uint64_t bucket_upper_bound(size_t index)
+  {
+    if (index < sub_buckets) {
+      return index;
+    }
+    size_t shift = index / sub_buckets - 1;
+    uint64_t lower = (sub_buckets + index % sub_buckets) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+  }
+
+  std::vector<uint64_t> buckets;
+};
+
 #endif  // RTTEST__MATH_UTILS_HPP_
@@ -51,6 +51,30 @@ struct rttest_results
 
   size_t minor_pagefaults;
   size_t major_pagefaults;
+
+  // Allocator activity reported through the allocator hooks, see rttest_allocator_hook_allocate
+  size_t allocations;
+  size_t deallocations;
+  uint64_t allocated_bytes;
+  uint64_t allocator_time_ns;
+};
+
+/// Allocator calls made by a thread, as reported by instrumented allocators.
+struct rttest_allocator_activity
+{
+  uint64_t allocations;
+  uint64_t deallocations;
+  uint64_t allocated_bytes;
+  // Time spent inside the allocator, allocating and deallocating
+  uint64_t time_ns;
+};
+
+struct rttest_sample_statistics
+{
+  int64_t min;
+  int64_t max;
+  double mean;
+  double stddev;
 };
 
 /// \brief Initialize rttest with arguments
@@ -160,12 +184,40 @@ int rttest_set_sched_priority(const size_t sched_priority, const int policy);
 /// \return Error code to propagate to main
 int rttest_set_thread_default_priority();
 
-/// \brief Get rusage (pagefaults) and record in the sample buffer at a
-/// particular iteration
+/// \brief Get rusage (pagefaults) and the allocator activity and record them in the sample
+/// buffer at a particular iteration
 /// \param[in] i Index at which to store the pagefault information.
 /// \return Error code to propagate to main
 int rttest_get_next_rusage(size_t i);
 
+/// \brief Report allocations made by the calling thread.
+/// Called by allocators, such as tlsf_heap_allocator and the tlsf_cpp_global malloc
+/// replacement, which declare it as a weak symbol and only call it when rttest is linked in.
+/// Every thread counts its own activity, so the hooks are real time safe and never allocate.
+/// \param[in] count Number of blocks allocated
+/// \param[in] bytes Total size of the blocks
+/// \param[in] duration_ns Time spent in the allocator
+void rttest_allocator_hook_allocate(size_t count, size_t bytes, uint64_t duration_ns);
+
+/// \brief Report deallocations made by the calling thread, see rttest_allocator_hook_allocate.
+/// \param[in] count Number of blocks freed
+/// \param[in] duration_ns Time spent in the allocator
+void rttest_allocator_hook_deallocate(size_t count, uint64_t duration_ns);
+
+/// \brief Get the allocator activity reported by the calling thread so far.
+/// \param[out] activity The struct to fill in
+/// \return Error code if activity is NULL
+int rttest_get_allocator_activity(struct rttest_allocator_activity * activity);
+
+/// \brief Get the allocator activity recorded at the given iteration.
+/// rttest_get_next_rusage records it alongside the pagefaults, as the difference to the
+/// previous iteration.
+/// \param[in] iteration Iteration of the test to get the activity from
+/// \param[out] activity The struct to fill in
+/// \return Error code if the iteration is out of range or activity is NULL
+int rttest_get_allocator_activity_at(
+  const size_t iteration, struct rttest_allocator_activity * activity);
+
 /// \brief Calculate statistics and fill the given results struct.
 /// \param[in] results The results struct to fill with statistics.
 /// \return Error code if results struct is NULL or if calculations invalid
@@ -181,6 +233,46 @@ int rttest_get_statistics(struct rttest_results * results);
 /// wakeup time and the actual wakeup time
 int rttest_get_sample_at(const size_t iteration, int64_t * sample);
 
+/// \brief Add a column of user samples, e.g. a latency measured by the user
+/// function, to the sample buffer of this thread.
+/// The column is written to the results file after the pagefault and allocator columns.
+/// Not real time safe; call it after rttest_init and before spinning.
+/// \param[in] name Name of the column in the results file; must not contain spaces
+/// \return Index of the new column, or -1 on error
+int rttest_add_sample_column(const char * name);
+
+/// \brief Record a user sample in a column at the given iteration.
+/// Real time safe.
+/// \param[in] column Index returned by rttest_add_sample_column
+/// \param[in] iteration Iteration the sample belongs to
+/// \param[in] sample The sample
+/// \return Error code if the column or the iteration is out of range
+int rttest_set_column_sample_at(int column, const size_t iteration, int64_t sample);
+
+/// \brief Get a user sample from a column at the given iteration.
+/// \param[in] column Index returned by rttest_add_sample_column
+/// \param[in] iteration Iteration of the test to get the sample from
+/// \param[out] sample The sample
+/// \return Error code if the column or the iteration is out of range
+int rttest_get_column_sample_at(int column, const size_t iteration, int64_t * sample);
+
+/// \brief Calculate statistics over all samples of a column.
+/// \param[in] column Index returned by rttest_add_sample_column
+/// \param[out] statistics The struct to fill in
+/// \return Error code if the column is out of range or statistics is NULL
+int rttest_calculate_column_statistics(
+  int column, struct rttest_sample_statistics * statistics);
+
+/// \brief Time a list of system calls in every iteration of this thread, after the user
+/// function, e.g. to compare their tail latency under real-time priority across kernels.
+/// Every probe records into its own sample column, named syscall_<probe>, and into a latency
+/// histogram summarized by rttest_finish. Also set by the -c argument of rttest_read_args.
+/// Not real time safe; call it after rttest_init and before spinning.
+/// \param[in] probes Comma separated probe names, or "all": clock_gettime, getpid,
+/// eventfd_read, futex_wake, sched_yield, pipe_write, mmap, munmap, mprotect
+/// \return Error code if a probe is unknown or the probes were already set
+int rttest_set_syscall_probes(const char * probes);
+
 /// \brief Write the sample buffer to a file.
 /// \return Error code to propagate to main
 int rttest_write_results();
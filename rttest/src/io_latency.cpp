@@ -0,0 +1,491 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Latency of file writes issued from a real-time loop.
+//
+// Every rttest iteration writes one block to a scratch file and records two columns:
+// submit_latency, the time the rttest thread spent in the system call, and
+// completion_latency, the time from the start of the submission until the write was seen to
+// be complete. The synchronous modes complete when the call returns, so both columns are the
+// same; io_uring writes are reaped without blocking at the start of the following iterations.
+//
+// Modes:
+//   write         write() to a buffered file
+//   direct        pwrite() to a file opened with O_DIRECT
+//   uring         IORING_OP_WRITE submissions to a buffered file
+//   uring_direct  IORING_OP_WRITE submissions to a file opened with O_DIRECT
+//
+// Usage: rttest_io_latency [rttest options] [mode=write] [size=bytes] [depth=n] [file=path]
+//        [dsync=1]
+//
+// The block size defaults to 4096 bytes, may be up to 64 MiB and is rounded up to a multiple
+// of 4096 with O_DIRECT. depth is the number of io_uring writes in flight, 16 by default and
+// at most 32768; an iteration that finds them all pending skips its write. Skipped and failed
+// writes are recorded as -1 and left out of the printed statistics. dsync=1 opens the file
+// with O_DSYNC. The writes cycle through the first 64 MiB of the file, which defaults to
+// rttest_io_latency.dat and is overwritten and removed. A finite iteration count is required,
+// see -i.
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rttest/math_utils.hpp>
+#include <rttest/rttest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t direct_alignment = 4096;
+constexpr off_t file_span = 64 * 1024 * 1024;
+// IORING_MAX_ENTRIES of the kernel, the largest ring io_uring_setup accepts.
+constexpr size_t max_depth = 32768;
+
+int64_t now_ns()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// A minimal io_uring on the raw system calls: one submission per call, completions reaped
+// from the shared ring without entering the kernel.
+class uring
+{
+public:
+  ~uring()
+  {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool init(unsigned entries)
+  {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) {
+      perror("io_uring_setup failed");
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == nullptr) {
+      return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = map(cq_ring_size_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == nullptr) {
+        return false;
+      }
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe *>(map(sqes_size_, IORING_OFF_SQES));
+    if (sqes_ == nullptr) {
+      return false;
+    }
+
+    sq_tail_ = ring_field(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *ring_field(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = ring_field(sq_ring_, params.sq_off.array);
+    cq_head_ = ring_field(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_field(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *ring_field(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe *>(
+      static_cast<char *>(cq_ring_) + params.cq_off.cqes);
+    return true;
+  }
+
+  // Queue a write and submit it; returns the result of io_uring_enter. A write the kernel did
+  // not take is taken off the queue again, so that no later call submits it.
+  int submit_write(int fd, const void * buffer, size_t size, off_t offset, uint64_t user_data)
+  {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe * sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    int submitted = static_cast<int>(syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0));
+    if (submitted < 1) {
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    }
+    return submitted;
+  }
+
+  // Block until at least one completion is available.
+  int wait()
+  {
+    return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+  }
+
+  // Call handle(user_data, res) for every available completion; returns their number.
+  template<typename Handler>
+  size_t reap(Handler handle)
+  {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    size_t count = 0;
+    for (; head != tail; ++head, ++count) {
+      const struct io_uring_cqe & cqe = cqes_[head & cq_mask_];
+      handle(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+  }
+
+private:
+  void * map(size_t size, off_t offset)
+  {
+    void * ring = mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+    if (ring == MAP_FAILED) {
+      perror("mmap of the io_uring failed");
+      return nullptr;
+    }
+    return ring;
+  }
+
+  static unsigned * ring_field(void * ring, unsigned offset)
+  {
+    return reinterpret_cast<unsigned *>(static_cast<char *>(ring) + offset);
+  }
+
+  int fd_ = -1;
+  void * sq_ring_ = nullptr;
+  void * cq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  struct io_uring_sqe * sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned * sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned * sq_array_ = nullptr;
+  unsigned * cq_head_ = nullptr;
+  unsigned * cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe * cqes_ = nullptr;
+};
+
+enum class io_mode
+{
+  write,
+  direct,
+  uring,
+  uring_direct,
+};
+
+struct writer
+{
+  static void * iteration(void * args)
+  {
+    auto self = static_cast<writer *>(args);
+    size_t i = self->sequence++;
+    off_t offset = static_cast<off_t>((i * self->size) % static_cast<size_t>(self->span));
+    if (self->mode == io_mode::uring || self->mode == io_mode::uring_direct) {
+      self->reap();
+      if (self->in_flight == self->depth) {
+        rttest_set_column_sample_at(self->submit_column, i, -1);
+        rttest_set_column_sample_at(self->completion_column, i, -1);
+        ++self->skipped;
+        return nullptr;
+      }
+      int64_t start = now_ns();
+      self->submitted_ns[i] = start;
+      int submitted = self->ring.submit_write(self->fd, self->buffer, self->size, offset, i);
+      int64_t end = now_ns();
+      if (submitted == 1) {
+        ++self->in_flight;
+        rttest_set_column_sample_at(self->submit_column, i, end - start);
+      } else {
+        ++self->errors;
+        rttest_set_column_sample_at(self->submit_column, i, -1);
+        rttest_set_column_sample_at(self->completion_column, i, -1);
+      }
+      return nullptr;
+    }
+
+    int64_t start = now_ns();
+    ssize_t written;
+    if (self->mode == io_mode::write) {
+      if (offset == 0) {
+        lseek(self->fd, 0, SEEK_SET);
+        start = now_ns();
+      }
+      written = ::write(self->fd, self->buffer, self->size);
+    } else {
+      written = pwrite(self->fd, self->buffer, self->size, offset);
+    }
+    int64_t latency = now_ns() - start;
+    if (written != static_cast<ssize_t>(self->size)) {
+      ++self->errors;
+      latency = -1;
+    }
+    rttest_set_column_sample_at(self->submit_column, i, latency);
+    rttest_set_column_sample_at(self->completion_column, i, latency);
+    return nullptr;
+  }
+
+  // Record the completion latency of the finished io_uring writes.
+  void reap()
+  {
+    int64_t reaped_ns = now_ns();
+    in_flight -= ring.reap(
+      [this, reaped_ns](uint64_t i, int32_t res) {
+        bool complete = res == static_cast<int32_t>(size);
+        if (!complete) {
+          ++errors;
+        }
+        rttest_set_column_sample_at(
+          completion_column, i, complete ? reaped_ns - submitted_ns[i] : -1);
+      });
+  }
+
+  io_mode mode;
+  int fd = -1;
+  void * buffer = nullptr;
+  size_t size = 0;
+  off_t span = 0;
+  uring ring;
+  size_t depth = 0;
+  size_t in_flight = 0;
+  std::vector<int64_t> submitted_ns;
+  size_t sequence = 0;
+  size_t skipped = 0;
+  size_t errors = 0;
+  int submit_column = -1;
+  int completion_column = -1;
+};
+
+// Statistics of the valid samples of a column: -1 marks a skipped or failed write.
+void print_column(const char * name, int column, size_t iterations)
+{
+  std::vector<int64_t> samples;
+  for (size_t i = 0; i < iterations; ++i) {
+    int64_t sample;
+    if (rttest_get_column_sample_at(column, i, &sample) == 0 && sample >= 0) {
+      samples.push_back(sample);
+    }
+  }
+  if (samples.empty()) {
+    printf("%s: no samples\n", name);
+    return;
+  }
+  printf(
+    "%s: min %lld, max %lld, mean %.1f, stddev %.1f over %zu samples\n", name,
+    static_cast<long long>(*std::min_element(samples.begin(), samples.end())),  // NOLINT
+    static_cast<long long>(*std::max_element(samples.begin(), samples.end())),  // NOLINT
+    std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size(),
+    calculate_stddev(samples), samples.size());
+}
+
+// Parse a decimal number of at most max; signs, suffixes and larger values are rejected.
+bool parse_number(const std::string & text, size_t max, size_t & value)
+{
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  errno = 0;
+  char * end = nullptr;
+  unsigned long long parsed = strtoull(text.c_str(), &end, 10);  // NOLINT(runtime/int)
+  if (errno == ERANGE || *end != '\0' || parsed > max) {
+    return false;
+  }
+  value = static_cast<size_t>(parsed);
+  return true;
+}
+
+void print_usage(const char * program)
+{
+  fprintf(
+    stderr, "Usage: %s [rttest options] [mode=write] [size=bytes] [depth=n] [file=path] "
+    "[dsync=1]\n", program);
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  std::string mode_name = "write";
+  std::string path = "rttest_io_latency.dat";
+  size_t size = 4096;
+  size_t depth = 16;
+  bool dsync = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 5, "mode=") == 0) {
+      mode_name = arg.substr(5);
+    } else if (arg.compare(0, 5, "size=") == 0) {
+      if (!parse_number(arg.substr(5), static_cast<size_t>(file_span), size)) {
+        fprintf(stderr, "Invalid block size: %s\n", arg.substr(5).c_str());
+        print_usage(argv[0]);
+        return -1;
+      }
+      size = std::max<size_t>(size, 1);
+    } else if (arg.compare(0, 6, "depth=") == 0) {
+      if (!parse_number(arg.substr(6), max_depth, depth)) {
+        fprintf(stderr, "Invalid depth: %s\n", arg.substr(6).c_str());
+        print_usage(argv[0]);
+        return -1;
+      }
+      depth = std::max<size_t>(depth, 1);
+    } else if (arg.compare(0, 5, "file=") == 0) {
+      path = arg.substr(5);
+    } else if (arg.compare(0, 6, "dsync=") == 0) {
+      dsync = arg.substr(6) != "0";
+    }
+  }
+
+  writer loop;
+  if (mode_name == "write") {
+    loop.mode = io_mode::write;
+  } else if (mode_name == "direct") {
+    loop.mode = io_mode::direct;
+  } else if (mode_name == "uring") {
+    loop.mode = io_mode::uring;
+  } else if (mode_name == "uring_direct") {
+    loop.mode = io_mode::uring_direct;
+  } else {
+    fprintf(stderr, "Unknown mode: %s\n", mode_name.c_str());
+    return -1;
+  }
+  bool direct = loop.mode == io_mode::direct || loop.mode == io_mode::uring_direct;
+  bool uses_uring = loop.mode == io_mode::uring || loop.mode == io_mode::uring_direct;
+  if (direct) {
+    size = (size + direct_alignment - 1) / direct_alignment * direct_alignment;
+  }
+
+  if (rttest_read_args(argc, argv) != 0) {
+    perror("Couldn't read arguments for rttest");
+    return -1;
+  }
+  struct rttest_params params;
+  rttest_get_params(&params);
+  if (params.iterations == 0) {
+    fprintf(stderr, "rttest_io_latency needs a finite number of iterations\n");
+    return -1;
+  }
+  printf(
+    "Mode: %s, block size: %zu bytes, %zu writes%s.\n", mode_name.c_str(), size,
+    params.iterations, dsync ? ", O_DSYNC" : "");
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  if (direct) {
+    flags |= O_DIRECT;
+  }
+  if (dsync) {
+    flags |= O_DSYNC;
+  }
+  loop.fd = open(path.c_str(), flags, 0644);
+  if (loop.fd < 0) {
+    fprintf(stderr, "Couldn't open %s: %s\n", path.c_str(), strerror(errno));
+    return -1;
+  }
+  if (posix_memalign(&loop.buffer, direct_alignment, size) != 0) {
+    fprintf(stderr, "Couldn't allocate the write buffer\n");
+    close(loop.fd);
+    unlink(path.c_str());
+    return -1;
+  }
+  memset(loop.buffer, 0x5a, size);
+  loop.size = size;
+  loop.span = std::max<off_t>(
+    file_span / static_cast<off_t>(size) * static_cast<off_t>(size), static_cast<off_t>(size));
+  loop.depth = depth;
+  if (uses_uring) {
+    loop.submitted_ns.resize(params.iterations, 0);
+    if (!loop.ring.init(static_cast<unsigned>(depth))) {
+      free(loop.buffer);
+      close(loop.fd);
+      unlink(path.c_str());
+      return -1;
+    }
+  }
+
+  loop.submit_column = rttest_add_sample_column("submit_latency");
+  loop.completion_column = rttest_add_sample_column("completion_latency");
+  if (loop.submit_column < 0 || loop.completion_column < 0) {
+    return -1;
+  }
+  if (rttest_lock_and_prefault_dynamic() != 0) {
+    fprintf(stderr, "Couldn't lock all cached virtual memory.\n");
+    fprintf(stderr, "Pagefaults from reading pages not yet mapped into RAM will be recorded.\n");
+  }
+  if (rttest_set_thread_default_priority() != 0) {
+    fprintf(stderr, "Couldn't set the real-time scheduling priority; running without it.\n");
+  }
+
+  int result = rttest_spin(writer::iteration, &loop);
+
+  // Wait for the io_uring writes still in flight; their completion latency includes the wait.
+  while (loop.in_flight > 0) {
+    if (loop.ring.wait() < 0 && errno != EINTR) {
+      perror("io_uring_enter failed");
+      break;
+    }
+    loop.reap();
+  }
+
+  print_column("Submit latency (ns)", loop.submit_column, params.iterations);
+  print_column("Completion latency (ns)", loop.completion_column, params.iterations);
+  if (loop.skipped > 0) {
+    printf("Skipped %zu writes with %zu already in flight\n", loop.skipped, depth);
+  }
+  if (loop.errors > 0) {
+    printf("%zu writes failed or were short\n", loop.errors);
+  }
+
+  rttest_write_results();
+  rttest_finish();
+  free(loop.buffer);
+  close(loop.fd);
+  unlink(path.c_str());
+  return result;
+}
@@ -0,0 +1,558 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// One-way latency of inter-process transports, measured between two processes.
+//
+// The rttest loop of the parent process is the sender: every iteration stamps a message with
+// CLOCK_MONOTONIC and sends it. A forked receiver process, locked in memory and at the same
+// real-time priority, blocks on the transport and stores the delay of every message in shared
+// memory. After the loop, the delays become the one_way_latency column of the rttest results,
+// next to the wakeup latency of the sender and the time spent in its send call. Lost messages
+// and failed sends are recorded as -1.
+//
+// Transports:
+//   shm          a lock-free single-producer ring in shared memory; the receiver sleeps on a
+//                futex when the ring is empty and the sender wakes it
+//   unix_stream  a UNIX stream socket pair
+//   unix_dgram   a UNIX datagram socket pair
+//   udp          UDP over the loopback interface
+//   pipe         a pipe
+//   mq           a POSIX message queue
+//
+// Usage: rttest_ipc_latency [rttest options] [transport=shm] [payload=bytes]
+//
+// The payload includes a 16 byte header, defaults to 64 bytes and may be up to 16 MiB. A finite
+// iteration count is required, see -i.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <mqueue.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rttest/math_utils.hpp>
+#include <rttest/rttest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct message_header
+{
+  uint64_t sequence;
+  int64_t sent_ns;
+};
+
+// Sequence numbers of messages that are not samples.
+constexpr uint64_t warmup_sequence = UINT64_MAX - 1;
+constexpr uint64_t stop_sequence = UINT64_MAX;
+
+int64_t now_ns()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+// One direction of a transport, set up before the fork and used by one process on each end.
+class transport
+{
+public:
+  virtual ~transport() = default;
+
+  /// Drop the resources of the other end, after the fork.
+  virtual void become_sender() {}
+  virtual void become_receiver() {}
+
+  /// Send a whole message. Returns false on error.
+  virtual bool send(const char * data, size_t size) = 0;
+  /// Block until a whole message has been received. Returns false on error.
+  virtual bool receive(char * data, size_t size) = 0;
+};
+
+// Pipes and sockets: one descriptor for each end.
+class fd_transport : public transport
+{
+public:
+  fd_transport(int send_fd, int receive_fd, bool stream)
+  : send_fd_(send_fd), receive_fd_(receive_fd), stream_(stream)
+  {
+  }
+
+  ~fd_transport() override
+  {
+    for (int fd : {send_fd_, receive_fd_}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  void become_sender() override
+  {
+    close(receive_fd_);
+    receive_fd_ = -1;
+  }
+
+  void become_receiver() override
+  {
+    close(send_fd_);
+    send_fd_ = -1;
+  }
+
+  bool send(const char * data, size_t size) override
+  {
+    while (size > 0) {
+      ssize_t sent = write(send_fd_, data, size);
+      if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      if (sent <= 0 || (!stream_ && static_cast<size_t>(sent) != size)) {
+        return false;
+      }
+      data += sent;
+      size -= static_cast<size_t>(sent);
+    }
+    return true;
+  }
+
+  bool receive(char * data, size_t size) override
+  {
+    while (size > 0) {
+      ssize_t received = read(receive_fd_, data, size);
+      if (received < 0 && errno == EINTR) {
+        continue;
+      }
+      if (received <= 0 || (!stream_ && static_cast<size_t>(received) != size)) {
+        return false;
+      }
+      data += received;
+      size -= static_cast<size_t>(received);
+    }
+    return true;
+  }
+
+private:
+  int send_fd_;
+  int receive_fd_;
+  bool stream_;
+};
+
+class mq_transport : public transport
+{
+public:
+  explicit mq_transport(mqd_t queue)
+  : queue_(queue)
+  {
+  }
+
+  ~mq_transport() override
+  {
+    mq_close(queue_);
+  }
+
+  bool send(const char * data, size_t size) override
+  {
+    return mq_send(queue_, data, size, 0) == 0;
+  }
+
+  bool receive(char * data, size_t size) override
+  {
+    ssize_t received;
+    do {
+      received = mq_receive(queue_, data, size, nullptr);
+    } while (received < 0 && errno == EINTR);
+    return received == static_cast<ssize_t>(size);
+  }
+
+private:
+  mqd_t queue_;
+};
+
+// A single-producer, single-consumer ring in a shared mapping. The head doubles as the futex
+// the receiver sleeps on; the sender only makes the wake-up system call when the receiver
+// announced that it is about to sleep.
+class shm_ring_transport : public transport
+{
+public:
+  static constexpr uint32_t slot_count = 64;
+
+  explicit shm_ring_transport(size_t payload)
+  : slot_size_((payload + 63) / 64 * 64),
+    mapping_size_(sizeof(control) + slot_count * slot_size_)
+  {
+    void * mapping = mmap(
+      nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    control_ = new (mapping) control();
+    slots_ = static_cast<char *>(mapping) + sizeof(control);
+  }
+
+  ~shm_ring_transport() override
+  {
+    munmap(control_, mapping_size_);
+  }
+
+  bool send(const char * data, size_t size) override
+  {
+    uint32_t head = control_->head.load(std::memory_order_relaxed);
+    // The receiver drains the ring much faster than a periodic sender fills it.
+    while (head - control_->tail.load(std::memory_order_acquire) == slot_count) {
+      sched_yield();
+    }
+    memcpy(slots_ + (head % slot_count) * slot_size_, data, size);
+    control_->head.store(head + 1, std::memory_order_seq_cst);
+    if (control_->receiver_waiting.load(std::memory_order_seq_cst)) {
+      futex(&control_->head, FUTEX_WAKE, 1);
+    }
+    return true;
+  }
+
+  bool receive(char * data, size_t size) override
+  {
+    uint32_t tail = control_->tail.load(std::memory_order_relaxed);
+    while (control_->head.load(std::memory_order_acquire) == tail) {
+      control_->receiver_waiting.store(1, std::memory_order_seq_cst);
+      if (control_->head.load(std::memory_order_seq_cst) == tail) {
+        futex(&control_->head, FUTEX_WAIT, tail);
+      }
+      control_->receiver_waiting.store(0, std::memory_order_relaxed);
+    }
+    memcpy(data, slots_ + (tail % slot_count) * slot_size_, size);
+    control_->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  struct control
+  {
+    alignas(64) std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> receiver_waiting{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+  };
+
+  static void futex(std::atomic<uint32_t> * word, int op, uint32_t value)
+  {
+    // Not FUTEX_PRIVATE_FLAG: the word is shared with the other process.
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, nullptr, nullptr, 0);
+  }
+
+  size_t slot_size_;
+  size_t mapping_size_;
+  control * control_;
+  char * slots_;
+};
+
+std::unique_ptr<transport> make_transport(const std::string & name, size_t payload)
+{
+  if (name == "shm") {
+    return std::make_unique<shm_ring_transport>(payload);
+  }
+  if (name == "unix_stream" || name == "unix_dgram") {
+    bool stream = name == "unix_stream";
+    int fds[2];
+    if (socketpair(AF_UNIX, stream ? SOCK_STREAM : SOCK_DGRAM, 0, fds) != 0) {
+      perror("socketpair failed");
+      return nullptr;
+    }
+    return std::make_unique<fd_transport>(fds[0], fds[1], stream);
+  }
+  if (name == "pipe") {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      perror("pipe failed");
+      return nullptr;
+    }
+    return std::make_unique<fd_transport>(fds[1], fds[0], true);
+  }
+  if (name == "udp") {
+    int receive_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int send_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (receive_fd < 0 || send_fd < 0 ||
+      bind(receive_fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+      getsockname(receive_fd, reinterpret_cast<struct sockaddr *>(&address), &length) != 0 ||
+      connect(send_fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+    {
+      perror("setting up the UDP sockets failed");
+      return nullptr;
+    }
+    return std::make_unique<fd_transport>(send_fd, receive_fd, false);
+  }
+  if (name == "mq") {
+    std::string queue_name = "/rttest_ipc_latency_" + std::to_string(getpid());
+    struct mq_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.mq_maxmsg = 10;
+    attributes.mq_msgsize = static_cast<long>(payload);  // NOLINT(runtime/int)
+    mqd_t queue = mq_open(queue_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600, &attributes);
+    if (queue == static_cast<mqd_t>(-1)) {
+      perror("mq_open failed; the payload may exceed /proc/sys/fs/mqueue/msgsize_max");
+      return nullptr;
+    }
+    // The descriptor stays valid in both processes.
+    mq_unlink(queue_name.c_str());
+    return std::make_unique<mq_transport>(queue);
+  }
+  fprintf(stderr, "Unknown transport: %s\n", name.c_str());
+  return nullptr;
+}
+
+// Runs in the child: receive until the stop message and store the delay of every sample.
+int receive_loop(transport & channel, size_t payload, int64_t * latencies, size_t iterations)
+{
+  std::vector<char> buffer(payload);
+  while (channel.receive(buffer.data(), payload)) {
+    int64_t received_ns = now_ns();
+    message_header header;
+    memcpy(&header, buffer.data(), sizeof(header));
+    if (header.sequence == stop_sequence) {
+      return 0;
+    }
+    if (header.sequence < iterations) {
+      latencies[header.sequence] = received_ns - header.sent_ns;
+    }
+  }
+  return 1;
+}
+
+struct sender
+{
+  static void * iteration(void * args)
+  {
+    auto self = static_cast<sender *>(args);
+    message_header header{self->sequence, now_ns()};
+    memcpy(self->buffer.data(), &header, sizeof(header));
+    bool sent = self->channel->send(self->buffer.data(), self->buffer.size());
+    rttest_set_column_sample_at(
+      self->send_column, self->sequence, sent ? now_ns() - header.sent_ns : -1);
+    ++self->sequence;
+    return nullptr;
+  }
+
+  bool send_control(uint64_t sequence)
+  {
+    message_header header{sequence, now_ns()};
+    memcpy(buffer.data(), &header, sizeof(header));
+    return channel->send(buffer.data(), buffer.size());
+  }
+
+  transport * channel;
+  std::vector<char> buffer;
+  uint64_t sequence = 0;
+  int send_column = -1;
+};
+
+// Statistics of the valid samples of a column: -1 marks a failed send or a lost message.
+void print_column(const char * name, int column, size_t iterations)
+{
+  std::vector<int64_t> samples;
+  for (size_t i = 0; i < iterations; ++i) {
+    int64_t sample;
+    if (rttest_get_column_sample_at(column, i, &sample) == 0 && sample >= 0) {
+      samples.push_back(sample);
+    }
+  }
+  if (samples.empty()) {
+    printf("%s: no samples\n", name);
+    return;
+  }
+  printf(
+    "%s: min %lld, max %lld, mean %.1f, stddev %.1f over %zu samples\n", name,
+    static_cast<long long>(*std::min_element(samples.begin(), samples.end())),  // NOLINT
+    static_cast<long long>(*std::max_element(samples.begin(), samples.end())),  // NOLINT
+    std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size(),
+    calculate_stddev(samples), samples.size());
+}
+
+// Percentiles of the delivered samples; the column statistics only give the extremes.
+void print_percentiles(const int64_t * latencies, size_t iterations)
+{
+  std::vector<int64_t> delivered;
+  for (size_t i = 0; i < iterations; ++i) {
+    if (latencies[i] >= 0) {
+      delivered.push_back(latencies[i]);
+    }
+  }
+  printf("Delivered %zu of %zu messages\n", delivered.size(), iterations);
+  if (delivered.empty()) {
+    return;
+  }
+  std::sort(delivered.begin(), delivered.end());
+  printf("One-way latency percentiles (ns):");
+  for (double fraction : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+    size_t index = std::min(
+      delivered.size() - 1, static_cast<size_t>(fraction * static_cast<double>(delivered.size())));
+    printf(" p%g %lld", fraction * 100.0, static_cast<long long>(delivered[index]));  // NOLINT
+  }
+  printf("\n");
+}
+
+// Parse a decimal number of at most max; signs, suffixes and larger values are rejected.
+bool parse_number(const std::string & text, size_t max, size_t & value)
+{
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  errno = 0;
+  char * end = nullptr;
+  unsigned long long parsed = strtoull(text.c_str(), &end, 10);  // NOLINT(runtime/int)
+  if (errno == ERANGE || *end != '\0' || parsed > max) {
+    return false;
+  }
+  value = static_cast<size_t>(parsed);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  std::string transport_name = "shm";
+  size_t payload = 64;
+  // 64 shm ring slots of this size still fit in a 1 GiB mapping.
+  constexpr size_t max_payload = 16 * 1024 * 1024;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 10, "transport=") == 0) {
+      transport_name = arg.substr(10);
+    } else if (arg.compare(0, 8, "payload=") == 0) {
+      if (!parse_number(arg.substr(8), max_payload, payload)) {
+        fprintf(stderr, "Invalid payload: %s\n", arg.substr(8).c_str());
+        fprintf(stderr, "Usage: %s [rttest options] [transport=shm] [payload=bytes]\n", argv[0]);
+        return -1;
+      }
+      payload = std::max(payload, sizeof(message_header));
+    }
+  }
+
+  if (rttest_read_args(argc, argv) != 0) {
+    perror("Couldn't read arguments for rttest");
+    return -1;
+  }
+  struct rttest_params params;
+  rttest_get_params(&params);
+  if (params.iterations == 0) {
+    fprintf(stderr, "rttest_ipc_latency needs a finite number of iterations\n");
+    return -1;
+  }
+  printf(
+    "Transport: %s, payload: %zu bytes, %zu messages.\n", transport_name.c_str(), payload,
+    params.iterations);
+
+  auto channel = make_transport(transport_name, payload);
+  if (!channel) {
+    return -1;
+  }
+  size_t latencies_size = params.iterations * sizeof(int64_t);
+  auto latencies = static_cast<int64_t *>(
+    mmap(
+      nullptr, latencies_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  if (latencies == MAP_FAILED) {
+    perror("mmap failed");
+    return -1;
+  }
+  std::fill(latencies, latencies + params.iterations, -1);
+
+  pid_t receiver = fork();
+  if (receiver < 0) {
+    perror("fork failed");
+    return -1;
+  }
+  if (receiver == 0) {
+    channel->become_receiver();
+    // Memory locks are not inherited.
+    if (rttest_lock_memory() != 0) {
+      fprintf(stderr, "Receiver couldn't lock memory.\n");
+    }
+    if (rttest_set_sched_priority(params.sched_priority, static_cast<int>(params.sched_policy)))
+    {
+      fprintf(stderr, "Receiver couldn't set the real-time scheduling priority.\n");
+    }
+    _exit(receive_loop(*channel, payload, latencies, params.iterations));
+  }
+  channel->become_sender();
+
+  sender loop;
+  loop.channel = channel.get();
+  loop.buffer.resize(payload);
+  loop.send_column = rttest_add_sample_column("send_duration");
+  int latency_column = rttest_add_sample_column("one_way_latency");
+  if (loop.send_column < 0 || latency_column < 0) {
+    return -1;
+  }
+  if (rttest_lock_and_prefault_dynamic() != 0) {
+    fprintf(stderr, "Couldn't lock all cached virtual memory.\n");
+    fprintf(stderr, "Pagefaults from reading pages not yet mapped into RAM will be recorded.\n");
+  }
+  if (rttest_set_thread_default_priority() != 0) {
+    fprintf(stderr, "Couldn't set the real-time scheduling priority; running without it.\n");
+  }
+  // Warm up both ends outside of the measurement.
+  for (size_t i = 0; i < 10; ++i) {
+    loop.send_control(warmup_sequence);
+  }
+
+  int result = rttest_spin(sender::iteration, &loop);
+
+  // Give the receiver a second to drain the transport, then stop it either way.
+  loop.send_control(stop_sequence);
+  int status = 0;
+  for (int waited_ms = 0; waitpid(receiver, &status, WNOHANG) == 0; ++waited_ms) {
+    if (waited_ms == 1000) {
+      fprintf(stderr, "The receiver did not stop; killing it.\n");
+      kill(receiver, SIGKILL);
+      waitpid(receiver, &status, 0);
+      break;
+    }
+    usleep(1000);
+  }
+
+  for (size_t i = 0; i < params.iterations; ++i) {
+    rttest_set_column_sample_at(latency_column, i, latencies[i]);
+  }
+  print_column("Send duration (ns)", loop.send_column, params.iterations);
+  print_column("One-way latency (ns)", latency_column, params.iterations);
+  print_percentiles(latencies, params.iterations);
+
+  rttest_write_results();
+  rttest_finish();
+  munmap(latencies, latencies_size);
+  return result;
+}
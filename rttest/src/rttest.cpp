@@ -15,10 +15,14 @@
 #include "rttest/rttest.h"
 
 #include <alloca.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <linux/futex.h>
 #include <malloc.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -28,6 +32,7 @@
 #include <fstream>
 #include <ios>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <ostream>
 #include <sstream>
@@ -55,6 +60,10 @@ public:
     this->latency_samples.resize(new_buffer_size);
     this->major_pagefaults.resize(new_buffer_size);
     this->minor_pagefaults.resize(new_buffer_size);
+    this->allocator_activity.resize(new_buffer_size);
+    for (auto & column : this->column_samples) {
+      column.resize(new_buffer_size);
+    }
   }
 
   // Stored in nanoseconds
@@ -63,6 +72,208 @@ public:
 
   std::vector<size_t> major_pagefaults;
   std::vector<size_t> minor_pagefaults;
+
+  // Allocator activity during each iteration, see rttest_allocator_hook_allocate
+  std::vector<rttest_allocator_activity> allocator_activity;
+
+  // User sample columns, see rttest_add_sample_column
+  std::vector<std::string> column_names;
+  std::vector<std::vector<int64_t>> column_samples;
+};
+
+// System calls timed by spin_once after the user function, see rttest_set_syscall_probes.
+class rttest_syscall_probes
+{
+public:
+  enum probe_type
+  {
+    clock_gettime_probe,
+    getpid_probe,
+    eventfd_read_probe,
+    futex_wake_probe,
+    sched_yield_probe,
+    pipe_write_probe,
+    mmap_probe,
+    munmap_probe,
+    mprotect_probe,
+  };
+
+  struct probe
+  {
+    probe_type type;
+    const char * name;
+    int column;
+    rttest_latency_histogram histogram;
+  };
+
+  rttest_syscall_probes() = default;
+
+  rttest_syscall_probes(const rttest_syscall_probes &) = delete;
+
+  rttest_syscall_probes & operator=(const rttest_syscall_probes &) = delete;
+
+  ~rttest_syscall_probes()
+  {
+    if (this->event_fd >= 0) {
+      close(this->event_fd);
+    }
+    if (this->pipe_fds[0] >= 0) {
+      close(this->pipe_fds[0]);
+      close(this->pipe_fds[1]);
+    }
+    if (this->page != MAP_FAILED) {
+      munmap(this->page, this->page_size);
+    }
+  }
+
+  static const char * const * names()
+  {
+    static const char * const probe_names[] = {
+      "clock_gettime", "getpid", "eventfd_read", "futex_wake", "sched_yield", "pipe_write",
+      "mmap", "munmap", "mprotect", nullptr};
+    return probe_names;
+  }
+
+  // Parse a comma separated list of probe names, or "all", and open what the probes use.
+  int init(const char * list)
+  {
+    std::stringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+      bool found = false;
+      for (size_t type = 0; names()[type] != nullptr; ++type) {
+        if (name != "all" && name != names()[type]) {
+          continue;
+        }
+        found = true;
+        auto same = [type](const probe & p) {return p.type == static_cast<probe_type>(type);};
+        if (std::none_of(this->probes.begin(), this->probes.end(), same)) {
+          this->probes.push_back({static_cast<probe_type>(type), names()[type], -1, {}});
+        }
+      }
+      if (!found) {
+        fprintf(stderr, "Unknown syscall probe: %s\n", name.c_str());
+        fprintf(stderr, "Valid probes are: all");
+        for (size_t type = 0; names()[type] != nullptr; ++type) {
+          fprintf(stderr, ", %s", names()[type]);
+        }
+        fprintf(stderr, "\n");
+        return -1;
+      }
+    }
+
+    this->page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    this->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->event_fd < 0 || pipe2(this->pipe_fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+      perror("Couldn't open the syscall probe file descriptors");
+      return -1;
+    }
+    this->page = mmap(
+      nullptr, this->page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (this->page == MAP_FAILED) {
+      perror("Couldn't map the syscall probe page");
+      return -1;
+    }
+    return 0;
+  }
+
+  // Time one call of the probe; the setup and cleanup around it are not timed.
+  int64_t run(probe & p)
+  {
+    struct timespec start, end;
+    switch (p.type) {
+      case clock_gettime_probe:
+        // The second call is the probe: the time between two calls is the cost of one.
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        break;
+      case getpid_probe:
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        syscall(SYS_getpid);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        break;
+      case eventfd_read_probe:
+        {
+          uint64_t value = 1;
+          ssize_t result = write(this->event_fd, &value, sizeof(value));
+          clock_gettime(CLOCK_MONOTONIC, &start);
+          result = read(this->event_fd, &value, sizeof(value));
+          clock_gettime(CLOCK_MONOTONIC, &end);
+          (void)result;
+          break;
+        }
+      case futex_wake_probe:
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        syscall(SYS_futex, &this->futex_word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        break;
+      case sched_yield_probe:
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        sched_yield();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        break;
+      case pipe_write_probe:
+        {
+          char byte = 0;
+          clock_gettime(CLOCK_MONOTONIC, &start);
+          ssize_t result = write(this->pipe_fds[1], &byte, 1);
+          clock_gettime(CLOCK_MONOTONIC, &end);
+          result = read(this->pipe_fds[0], &byte, 1);
+          (void)result;
+          break;
+        }
+      case mmap_probe:
+        {
+          clock_gettime(CLOCK_MONOTONIC, &start);
+          void * mapping = mmap(
+            nullptr, this->page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+            0);
+          clock_gettime(CLOCK_MONOTONIC, &end);
+          if (mapping != MAP_FAILED) {
+            munmap(mapping, this->page_size);
+          }
+          break;
+        }
+      case munmap_probe:
+        {
+          void * mapping = mmap(
+            nullptr, this->page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+            0);
+          if (mapping == MAP_FAILED) {
+            return -1;
+          }
+          clock_gettime(CLOCK_MONOTONIC, &start);
+          munmap(mapping, this->page_size);
+          clock_gettime(CLOCK_MONOTONIC, &end);
+          break;
+        }
+      case mprotect_probe:
+        this->page_writable = !this->page_writable;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        mprotect(
+          this->page, this->page_size,
+          this->page_writable ? PROT_READ | PROT_WRITE : PROT_READ);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        break;
+      default:
+        return -1;
+    }
+    struct timespec duration;
+    subtract_timespecs(&end, &start, &duration);
+    uint64_t latency = timespec_to_uint64(&duration);
+    p.histogram.add(latency);
+    return static_cast<int64_t>(latency);
+  }
+
+  std::vector<probe> probes;
+
+private:
+  int event_fd = -1;
+  int pipe_fds[2] = {-1, -1};
+  int futex_word = 0;
+  void * page = MAP_FAILED;
+  size_t page_size = 0;
+  bool page_writable = true;
 };
 
 class Rttest
@@ -71,6 +282,9 @@ private:
   struct rttest_params params;
   rttest_sample_buffer sample_buffer;
   struct rusage prev_usage;
+  struct rttest_allocator_activity prev_allocator_activity = {};
+  // Shared, so that the instance can be copied into rttest_instance_map
+  std::shared_ptr<rttest_syscall_probes> syscall_probes;
 
   pthread_t thread_id;
 
@@ -124,6 +338,19 @@ public:
 
   int get_sample_at(const size_t iteration, int64_t & sample) const;
 
+  int get_allocator_activity_at(
+    const size_t iteration, struct rttest_allocator_activity & activity) const;
+
+  int add_sample_column(const char * name);
+
+  int set_column_sample_at(int column, const size_t iteration, int64_t sample);
+
+  int get_column_sample_at(int column, const size_t iteration, int64_t & sample) const;
+
+  int calculate_column_statistics(int column, struct rttest_sample_statistics * statistics);
+
+  int set_syscall_probes(const char * probes);
+
   int write_results();
 
   int write_results_file(char * filename);
@@ -143,6 +370,12 @@ public:
 std::map<pthread_t, Rttest> rttest_instance_map;
 pthread_t initial_thread_id = 0;
 
+// Allocator activity of each thread, counted by the allocator hooks. The hooks may be called
+// from within malloc, so the counters must be reachable without allocating: initial-exec TLS
+// is set up when the library is loaded.
+static thread_local struct rttest_allocator_activity thread_allocator_activity
+__attribute__((tls_model("initial-exec")));
+
 Rttest::Rttest()
 {
   memset(&this->results, 0, sizeof(struct rttest_results));
@@ -238,9 +471,11 @@ int Rttest::read_args(int argc, char ** argv)
   // -f,--filename
   // Don't write a file unless filename specified
   char * filename = nullptr;
+  // -c,--syscall-probes
+  char * syscall_probes = nullptr;
   int c;
 
-  std::string args_string = "i:u:p:t:s:m:d:f:r:";
+  std::string args_string = "i:u:p:t:s:m:d:f:r:c:";
   opterr = 0;
   optind = 1;
 
@@ -305,6 +540,9 @@ int Rttest::read_args(int argc, char ** argv)
       case 'f':
         filename = optarg;
         break;
+      case 'c':
+        syscall_probes = optarg;
+        break;
       case '?':
         if (args_string.find(optopt) != std::string::npos) {
           fprintf(stderr, "Option -%c requires an argument.\n", optopt);
@@ -319,9 +557,13 @@ int Rttest::read_args(int argc, char ** argv)
     }
   }
 
-  return this->init(
+  int result = this->init(
     iterations, update_period, sched_policy, sched_priority,
     stack_size, prefault_dynamic_size, filename);
+  if (result == 0 && syscall_probes != nullptr) {
+    result = this->set_syscall_probes(syscall_probes);
+  }
+  return result;
 }
 
 int rttest_get_params(struct rttest_params * params_in)
@@ -454,6 +696,15 @@ int Rttest::get_next_rusage(size_t i)
     this->prev_usage.ru_majflt - prev_maj_pagefaults;
   this->sample_buffer.minor_pagefaults[i] =
     this->prev_usage.ru_minflt - prev_min_pagefaults;
+
+  const struct rttest_allocator_activity & current = thread_allocator_activity;
+  struct rttest_allocator_activity & delta = this->sample_buffer.allocator_activity[i];
+  delta.allocations = current.allocations - this->prev_allocator_activity.allocations;
+  delta.deallocations = current.deallocations - this->prev_allocator_activity.deallocations;
+  delta.allocated_bytes =
+    current.allocated_bytes - this->prev_allocator_activity.allocated_bytes;
+  delta.time_ns = current.time_ns - this->prev_allocator_activity.time_ns;
+  this->prev_allocator_activity = current;
   return 0;
 }
 
@@ -551,6 +802,7 @@ int Rttest::spin_once(
     }
     printf("Initial major pagefaults: %ld\n", this->prev_usage.ru_majflt);
     printf("Initial minor pagefaults: %ld\n", this->prev_usage.ru_minflt);
+    this->prev_allocator_activity = thread_allocator_activity;
   }
   struct timespec wakeup_time, current_time;
   multiply_timespec(update_period, i, &wakeup_time);
@@ -561,6 +813,11 @@ int Rttest::spin_once(
   this->record_jitter(&wakeup_time, &current_time, i);
 
   user_function(args);
+  if (this->syscall_probes) {
+    for (auto & probe : this->syscall_probes->probes) {
+      this->set_column_sample_at(probe.column, i, this->syscall_probes->run(probe));
+    }
+  }
   this->get_next_rusage(i);
   this->accumulate_statistics(i);
   return 0;
@@ -743,6 +1000,11 @@ int Rttest::accumulate_statistics(size_t iteration)
   }
   this->results.minor_pagefaults += sample_buffer.minor_pagefaults[i];
   this->results.major_pagefaults += sample_buffer.major_pagefaults[i];
+  const struct rttest_allocator_activity & activity = sample_buffer.allocator_activity[i];
+  this->results.allocations += activity.allocations;
+  this->results.deallocations += activity.deallocations;
+  this->results.allocated_bytes += activity.allocated_bytes;
+  this->results.allocator_time_ns += activity.time_ns;
   this->results_initialized = true;
   return 0;
 }
@@ -773,6 +1035,17 @@ int Rttest::calculate_statistics(struct rttest_results * output)
     this->sample_buffer.major_pagefaults.begin(),
     this->sample_buffer.major_pagefaults.end(), 0);
 
+  output->allocations = 0;
+  output->deallocations = 0;
+  output->allocated_bytes = 0;
+  output->allocator_time_ns = 0;
+  for (const auto & activity : this->sample_buffer.allocator_activity) {
+    output->allocations += activity.allocations;
+    output->deallocations += activity.deallocations;
+    output->allocated_bytes += activity.allocated_bytes;
+    output->allocator_time_ns += activity.time_ns;
+  }
+
   return 0;
 }
 
@@ -830,6 +1103,176 @@ int rttest_get_sample_at(const size_t iteration, int64_t * sample)
   return thread_rttest_instance->get_sample_at(iteration, *sample);
 }
 
+int Rttest::get_allocator_activity_at(
+  const size_t iteration, struct rttest_allocator_activity & activity) const
+{
+  if (this->params.iterations == 0) {
+    activity = this->sample_buffer.allocator_activity[0];
+    return 0;
+  }
+  if (iteration < this->params.iterations) {
+    activity = this->sample_buffer.allocator_activity[iteration];
+    return 0;
+  }
+  return -1;
+}
+
+int rttest_get_allocator_activity_at(
+  const size_t iteration, struct rttest_allocator_activity * activity)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  if (activity == NULL) {
+    return -1;
+  }
+  return thread_rttest_instance->get_allocator_activity_at(iteration, *activity);
+}
+
+void rttest_allocator_hook_allocate(size_t count, size_t bytes, uint64_t duration_ns)
+{
+  thread_allocator_activity.allocations += count;
+  thread_allocator_activity.allocated_bytes += bytes;
+  thread_allocator_activity.time_ns += duration_ns;
+}
+
+void rttest_allocator_hook_deallocate(size_t count, uint64_t duration_ns)
+{
+  thread_allocator_activity.deallocations += count;
+  thread_allocator_activity.time_ns += duration_ns;
+}
+
+int rttest_get_allocator_activity(struct rttest_allocator_activity * activity)
+{
+  if (activity == NULL) {
+    return -1;
+  }
+  *activity = thread_allocator_activity;
+  return 0;
+}
+
+int Rttest::add_sample_column(const char * name)
+{
+  if (name == NULL || strchr(name, ' ') != NULL) {
+    return -1;
+  }
+  this->sample_buffer.column_names.emplace_back(name);
+  this->sample_buffer.column_samples.emplace_back(
+    this->sample_buffer.latency_samples.size(), 0);
+  return static_cast<int>(this->sample_buffer.column_samples.size() - 1);
+}
+
+int rttest_add_sample_column(const char * name)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  return thread_rttest_instance->add_sample_column(name);
+}
+
+int Rttest::set_column_sample_at(int column, const size_t iteration, int64_t sample)
+{
+  if (column < 0 || static_cast<size_t>(column) >= this->sample_buffer.column_samples.size()) {
+    return -1;
+  }
+  size_t i = this->params.iterations == 0 ? 0 : iteration;
+  auto & samples = this->sample_buffer.column_samples[column];
+  if (i >= samples.size()) {
+    return -1;
+  }
+  samples[i] = sample;
+  return 0;
+}
+
+int rttest_set_column_sample_at(int column, const size_t iteration, int64_t sample)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  return thread_rttest_instance->set_column_sample_at(column, iteration, sample);
+}
+
+int Rttest::get_column_sample_at(int column, const size_t iteration, int64_t & sample) const
+{
+  if (column < 0 || static_cast<size_t>(column) >= this->sample_buffer.column_samples.size()) {
+    return -1;
+  }
+  size_t i = this->params.iterations == 0 ? 0 : iteration;
+  const auto & samples = this->sample_buffer.column_samples[column];
+  if (i >= samples.size()) {
+    return -1;
+  }
+  sample = samples[i];
+  return 0;
+}
+
+int rttest_get_column_sample_at(int column, const size_t iteration, int64_t * sample)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  if (sample == NULL) {
+    return -1;
+  }
+  return thread_rttest_instance->get_column_sample_at(column, iteration, *sample);
+}
+
+int Rttest::calculate_column_statistics(int column, struct rttest_sample_statistics * output)
+{
+  if (output == NULL) {
+    fprintf(stderr, "Need to allocate rttest_sample_statistics struct\n");
+    return -1;
+  }
+  if (column < 0 || static_cast<size_t>(column) >= this->sample_buffer.column_samples.size()) {
+    return -1;
+  }
+  const auto & samples = this->sample_buffer.column_samples[column];
+  output->min = *std::min_element(samples.begin(), samples.end());
+  output->max = *std::max_element(samples.begin(), samples.end());
+  output->mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  output->stddev = calculate_stddev(samples);
+  return 0;
+}
+
+int rttest_calculate_column_statistics(
+  int column, struct rttest_sample_statistics * statistics)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  return thread_rttest_instance->calculate_column_statistics(column, statistics);
+}
+
+int Rttest::set_syscall_probes(const char * probes)
+{
+  if (probes == NULL || this->syscall_probes) {
+    return -1;
+  }
+  auto new_probes = std::make_shared<rttest_syscall_probes>();
+  if (new_probes->init(probes) != 0) {
+    return -1;
+  }
+  for (auto & probe : new_probes->probes) {
+    probe.column = this->add_sample_column(("syscall_" + std::string(probe.name)).c_str());
+  }
+  this->syscall_probes = new_probes;
+  return 0;
+}
+
+int rttest_set_syscall_probes(const char * probes)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  return thread_rttest_instance->set_syscall_probes(probes);
+}
+
 std::string Rttest::results_to_string(char * name)
 {
   std::stringstream sstring;
@@ -842,11 +1285,24 @@ std::string Rttest::results_to_string(char * name)
   }
   sstring << "  - Minor pagefaults: " << results.minor_pagefaults << std::endl;
   sstring << "  - Major pagefaults: " << results.major_pagefaults << std::endl;
+  sstring << "  - Allocations: " << results.allocations << " (" << results.allocated_bytes <<
+    " bytes)" << std::endl;
+  sstring << "  - Deallocations: " << results.deallocations << std::endl;
+  sstring << "  - Time in allocator: " << results.allocator_time_ns << " ns" << std::endl;
   sstring << "  Latency (time after deadline was missed):" << std::endl;
   sstring << "    - Min: " << results.min_latency << " ns" << std::endl;
   sstring << "    - Max: " << results.max_latency << " ns" << std::endl;
   sstring << "    - Mean: " << results.mean_latency << " ns" << std::endl;
   sstring << "    - Standard deviation: " << results.latency_stddev << std::endl;
+  if (this->syscall_probes) {
+    sstring << "  Syscall latency (min, p50, p99, p99.9, max in ns):" << std::endl;
+    for (const auto & probe : this->syscall_probes->probes) {
+      const rttest_latency_histogram & histogram = probe.histogram;
+      sstring << "    - " << probe.name << ": " << histogram.min << ", " <<
+        histogram.percentile(0.5) << ", " << histogram.percentile(0.99) << ", " <<
+        histogram.percentile(0.999) << ", " << histogram.max << std::endl;
+    }
+  }
   sstring << std::endl;
 
   return sstring.str();
@@ -919,12 +1375,24 @@ int Rttest::write_results_file(char * filename)
     return -1;
   }
 
-  fstream << "iteration timestamp latency minor_pagefaults major_pagefaults" << std::endl;
+  fstream << "iteration timestamp latency minor_pagefaults major_pagefaults" <<
+    " allocations deallocations allocated_bytes allocator_ns";
+  for (const auto & name : this->sample_buffer.column_names) {
+    fstream << " " << name;
+  }
+  fstream << std::endl;
   for (size_t i = 0; i < this->sample_buffer.latency_samples.size(); ++i) {
     fstream << i << " " << timespec_to_uint64(&this->params.update_period) * i <<
       " " << this->sample_buffer.latency_samples[i] << " " <<
       this->sample_buffer.minor_pagefaults[i] << " " <<
-      this->sample_buffer.major_pagefaults[i] << std::endl;
+      this->sample_buffer.major_pagefaults[i];
+    const struct rttest_allocator_activity & activity = this->sample_buffer.allocator_activity[i];
+    fstream << " " << activity.allocations << " " << activity.deallocations << " " <<
+      activity.allocated_bytes << " " << activity.time_ns;
+    for (const auto & column : this->sample_buffer.column_samples) {
+      fstream << " " << column[i];
+    }
+    fstream << std::endl;
   }
 
   fstream.close();
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <sys/resource.h>
+#include <cstdio>
+#include <fstream>
 #include <string>
 
 #include <array>
@@ -177,6 +179,168 @@ TEST(TestApi, get_statistics) {
   EXPECT_EQ(0, rttest_finish());
 }
 
+TEST(TestApi, sample_columns) {
+  struct timespec update_period;
+  update_period.tv_sec = 0;
+  update_period.tv_nsec = 1000;
+  EXPECT_EQ(-1, rttest_add_sample_column("no_instance"));
+  EXPECT_EQ(0, rttest_init(4, update_period, SCHED_RR, 80, 0, 0, NULL));
+  EXPECT_EQ(-1, rttest_add_sample_column(NULL));
+  EXPECT_EQ(-1, rttest_add_sample_column("has space"));
+  int column = rttest_add_sample_column("user_latency");
+  EXPECT_EQ(0, column);
+  EXPECT_EQ(1, rttest_add_sample_column("user_count"));
+
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(0, rttest_set_column_sample_at(column, i, 10 * static_cast<int64_t>(i + 1)));
+  }
+  EXPECT_EQ(-1, rttest_set_column_sample_at(column, 4, 0));
+  EXPECT_EQ(-1, rttest_set_column_sample_at(2, 0, 0));
+
+  int64_t sample = 0;
+  EXPECT_EQ(0, rttest_get_column_sample_at(column, 2, &sample));
+  EXPECT_EQ(30, sample);
+  EXPECT_EQ(-1, rttest_get_column_sample_at(column, 0, NULL));
+
+  struct rttest_sample_statistics statistics;
+  EXPECT_EQ(-1, rttest_calculate_column_statistics(column, NULL));
+  EXPECT_EQ(0, rttest_calculate_column_statistics(column, &statistics));
+  EXPECT_EQ(10, statistics.min);
+  EXPECT_EQ(40, statistics.max);
+  EXPECT_DOUBLE_EQ(25.0, statistics.mean);
+  EXPECT_GT(statistics.stddev, 0.0);
+
+  char filename[] = "rttest_sample_columns.txt";
+  EXPECT_EQ(0, rttest_write_results_file(filename));
+  std::ifstream results(filename);
+  std::string header;
+  std::getline(results, header);
+  EXPECT_EQ(
+    "iteration timestamp latency minor_pagefaults major_pagefaults allocations deallocations "
+    "allocated_bytes allocator_ns user_latency user_count",
+    header);
+  std::remove(filename);
+
+  EXPECT_EQ(0, rttest_finish());
+}
+
+// Allocates like an instrumented allocator would: i blocks of 100 bytes at iteration i.
+void * allocating_callback(void * args)
+{
+  size_t * counter = static_cast<size_t *>(args);
+  if (*counter > 0) {
+    rttest_allocator_hook_allocate(*counter, *counter * 100, 50);
+    rttest_allocator_hook_deallocate(1, 10);
+  }
+  *counter = *counter + 1;
+  return 0;
+}
+
+TEST(TestApi, allocator_activity) {
+  struct timespec update_period, start_time;
+  update_period.tv_sec = 0;
+  update_period.tv_nsec = 1000;
+  struct rttest_allocator_activity activity;
+  EXPECT_EQ(-1, rttest_get_allocator_activity(NULL));
+  EXPECT_EQ(0, rttest_get_allocator_activity(&activity));
+  uint64_t allocations_before = activity.allocations;
+
+  EXPECT_EQ(0, rttest_init(4, update_period, SCHED_RR, 80, 0, 0, NULL));
+  // Activity before the first iteration is not attributed to it.
+  rttest_allocator_hook_allocate(1, 1000, 1000);
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  size_t counter = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(
+      0, rttest_spin_once(allocating_callback, static_cast<void *>(&counter), &start_time, i));
+  }
+
+  EXPECT_EQ(-1, rttest_get_allocator_activity_at(0, NULL));
+  EXPECT_EQ(-1, rttest_get_allocator_activity_at(4, &activity));
+  EXPECT_EQ(0, rttest_get_allocator_activity_at(0, &activity));
+  EXPECT_EQ(0u, activity.allocations);
+  EXPECT_EQ(0u, activity.time_ns);
+  EXPECT_EQ(0, rttest_get_allocator_activity_at(3, &activity));
+  EXPECT_EQ(3u, activity.allocations);
+  EXPECT_EQ(1u, activity.deallocations);
+  EXPECT_EQ(300u, activity.allocated_bytes);
+  EXPECT_EQ(60u, activity.time_ns);
+
+  struct rttest_results results;
+  EXPECT_EQ(0, rttest_get_statistics(&results));
+  EXPECT_EQ(6u, results.allocations);
+  EXPECT_EQ(3u, results.deallocations);
+  EXPECT_EQ(600u, results.allocated_bytes);
+  EXPECT_EQ(180u, results.allocator_time_ns);
+  EXPECT_EQ(0, rttest_get_allocator_activity(&activity));
+  EXPECT_EQ(allocations_before + 7, activity.allocations);
+
+  EXPECT_EQ(0, rttest_finish());
+}
+
+TEST(TestApi, syscall_probes) {
+  struct timespec update_period;
+  update_period.tv_sec = 0;
+  update_period.tv_nsec = 1000;
+  EXPECT_EQ(-1, rttest_set_syscall_probes("getpid"));
+  EXPECT_EQ(0, rttest_init(4, update_period, SCHED_RR, 80, 0, 0, NULL));
+  EXPECT_EQ(-1, rttest_set_syscall_probes(NULL));
+  // An unknown probe rejects the whole list and adds no columns.
+  EXPECT_EQ(-1, rttest_set_syscall_probes("getpid,no_such_probe"));
+  // Duplicates are timed once.
+  EXPECT_EQ(0, rttest_set_syscall_probes("getpid,mprotect,getpid"));
+  EXPECT_EQ(-1, rttest_set_syscall_probes("sched_yield"));
+  EXPECT_EQ(2, rttest_add_sample_column("user_latency"));
+
+  size_t counter = 0;
+  EXPECT_EQ(0, rttest_spin(test_callback, static_cast<void *>(&counter)));
+  EXPECT_EQ(4u, counter);
+  for (int column = 0; column < 2; ++column) {
+    for (size_t i = 0; i < 4; ++i) {
+      int64_t sample = -1;
+      EXPECT_EQ(0, rttest_get_column_sample_at(column, i, &sample));
+      EXPECT_GE(sample, 0);
+    }
+  }
+
+  char filename[] = "rttest_syscall_probes.txt";
+  EXPECT_EQ(0, rttest_write_results_file(filename));
+  std::ifstream results(filename);
+  std::string header;
+  std::getline(results, header);
+  EXPECT_EQ(
+    "iteration timestamp latency minor_pagefaults major_pagefaults allocations deallocations "
+    "allocated_bytes allocator_ns syscall_getpid syscall_mprotect user_latency",
+    header);
+  std::remove(filename);
+
+  EXPECT_EQ(0, rttest_finish());
+}
+
+TEST(TestApi, read_args_syscall_probes) {
+  char * argv[] = {
+    const_cast<char *>("test_data"),
+    const_cast<char *>("-i"), const_cast<char *>("3"),
+    const_cast<char *>("-u"), const_cast<char *>("1us"),
+    const_cast<char *>("-c"), const_cast<char *>("all")
+  };
+  EXPECT_EQ(0, rttest_read_args(7, argv));
+  size_t counter = 0;
+  EXPECT_EQ(0, rttest_spin(test_callback, static_cast<void *>(&counter)));
+  // One column for each of the nine probes.
+  int64_t sample = -1;
+  for (int column = 0; column < 9; ++column) {
+    EXPECT_EQ(0, rttest_get_column_sample_at(column, 2, &sample));
+    EXPECT_GE(sample, 0);
+  }
+  EXPECT_EQ(-1, rttest_get_column_sample_at(9, 2, &sample));
+  EXPECT_EQ(0, rttest_finish());
+
+  argv[6] = const_cast<char *>("getpid,no_such_probe");
+  EXPECT_EQ(-1, rttest_read_args(7, argv));
+  EXPECT_EQ(0, rttest_finish());
+}
+
 TEST(TestApi, running) {
   struct timespec update_period, start_time;
   clock_gettime(CLOCK_MONOTONIC, &start_time);
@@ -44,3 +44,56 @@ TEST(MathUtils, calculate_stddev) {
     99901, 25536, 100327, 100932};
   EXPECT_NEAR(36581.05, calculate_stddev(v_failed), 0.01);
 }
+
+TEST(MathUtils, latency_histogram_small_values_are_exact) {
+  rttest_latency_histogram histogram;
+  EXPECT_EQ(0u, histogram.percentile(0.5));
+  for (uint64_t sample = 0; sample < 16; ++sample) {
+    histogram.add(sample);
+  }
+  EXPECT_EQ(16u, histogram.count);
+  EXPECT_EQ(0u, histogram.min);
+  EXPECT_EQ(15u, histogram.max);
+  // Below 16 every bucket holds a single value.
+  EXPECT_EQ(0u, histogram.percentile(0.0));
+  EXPECT_EQ(3u, histogram.percentile(0.25));
+  EXPECT_EQ(7u, histogram.percentile(0.5));
+  EXPECT_EQ(15u, histogram.percentile(1.0));
+}
+
+TEST(MathUtils, latency_histogram_bucket_edges) {
+  rttest_latency_histogram histogram;
+  // From 1024 on, the buckets are 128 wide: [1024, 1151], [1152, 1279], ..., [1920, 2047],
+  // and then 256 wide from 2048.
+  for (uint64_t sample : {1024u, 1151u, 1152u, 2047u, 2048u}) {
+    histogram.add(sample);
+  }
+  EXPECT_EQ(1151u, histogram.percentile(0.2));
+  EXPECT_EQ(1151u, histogram.percentile(0.4));
+  EXPECT_EQ(1279u, histogram.percentile(0.6));
+  EXPECT_EQ(2047u, histogram.percentile(0.8));
+  // The upper bound of the last bucket is capped by the largest sample.
+  EXPECT_EQ(2048u, histogram.percentile(1.0));
+
+  rttest_latency_histogram powers;
+  powers.add(16);
+  powers.add(17);
+  powers.add(18);
+  EXPECT_EQ(17u, powers.percentile(0.5));
+  EXPECT_EQ(18u, powers.percentile(1.0));
+}
+
+TEST(MathUtils, latency_histogram_resolution) {
+  // Every percentile is within 1/8 above the sample it stands for.
+  for (uint64_t sample = 1; sample < (uint64_t(1) << 40); sample = sample * 3 + 1) {
+    rttest_latency_histogram histogram;
+    histogram.add(sample);
+    histogram.add(sample * 4);
+    uint64_t median = histogram.percentile(0.5);
+    EXPECT_GE(median, sample);
+    EXPECT_LE(median, sample + sample / 8);
+  }
+  rttest_latency_histogram extremes;
+  extremes.add(UINT64_MAX);
+  EXPECT_EQ(UINT64_MAX, extremes.percentile(0.5));
+}
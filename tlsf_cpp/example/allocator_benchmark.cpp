@@ -0,0 +1,270 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// End-to-end latency of the allocator_example pipeline.
+//
+// An rttest-managed loop publishes a timestamped message every update period and spins the
+// executor until the subscriber has received it. Besides the wakeup latency, every iteration
+// records the publish-to-callback latency and the number of heap allocations made by the
+// process, so that the allocators can be compared on both.
+//
+// Usage: tlsf_allocator_benchmark [rttest options] [std|tlsf|pool] [intra|inter]
+//
+//   std    std::allocator everywhere, the rclcpp default.
+//   tlsf   tlsf_heap_allocator for the publisher, subscription, executor and messages.
+//   pool   a tlsf_message_pool for the messages on top of a TLSF-backed executor.
+//   intra  intra-process communication (the default).
+//   inter  inter-process communication over the middleware on loopback.
+
+#include <malloc.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/allocator_memory_strategy.hpp"
+#include "rttest/rttest.h"
+#include "std_msgs/msg/u_int64.hpp"
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_message_pool.hpp"
+
+// Count every heap allocation of the process by interposing the glibc allocator.
+static std::atomic<uint64_t> g_allocations{0};
+
+extern "C"
+{
+extern void * __libc_malloc(size_t);
+extern void * __libc_calloc(size_t, size_t);
+extern void * __libc_realloc(void *, size_t);
+extern void * __libc_memalign(size_t, size_t);
+
+void * malloc(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void * realloc(void * ptr, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+void * memalign(size_t alignment, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+void * aligned_alloc(size_t alignment, size_t size)
+{
+  return memalign(alignment, size);
+}
+
+int posix_memalign(void ** ptr, size_t alignment, size_t size)
+{
+  void * result = memalign(alignment, size);
+  if (result == nullptr) {
+    return ENOMEM;
+  }
+  *ptr = result;
+  return 0;
+}
+}
+
+using rclcpp::memory_strategies::allocator_memory_strategy::AllocatorMemoryStrategy;
+using Message = std_msgs::msg::UInt64;
+
+static uint64_t now_ns()
+{
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Everything the rttest loop needs, for a publisher and subscription using Alloc.
+template<typename Alloc>
+struct benchmark
+{
+  using MessageAllocTraits = rclcpp::allocator::AllocRebind<Message, Alloc>;
+  using MessageAlloc = typename MessageAllocTraits::allocator_type;
+  using MessageDeleter = rclcpp::allocator::Deleter<MessageAlloc, Message>;
+  using MessageUniquePtr = std::unique_ptr<Message, MessageDeleter>;
+
+  benchmark(
+    rclcpp::Node::SharedPtr node, std::shared_ptr<Alloc> alloc, bool tlsf_executor)
+  : message_alloc(*alloc)
+  {
+    rclcpp::allocator::set_allocator_for_deleter(&message_deleter, &message_alloc);
+
+    rclcpp::PublisherOptionsWithAllocator<Alloc> publisher_options;
+    publisher_options.allocator = alloc;
+    publisher = node->create_publisher<Message>("allocator_benchmark", 10, publisher_options);
+
+    rclcpp::SubscriptionOptionsWithAllocator<Alloc> subscription_options;
+    subscription_options.allocator = alloc;
+    subscription = node->create_subscription<Message>(
+      "allocator_benchmark", 10,
+      [this](MessageUniquePtr msg) {
+        latency_ns = static_cast<int64_t>(now_ns() - msg->data);
+        received = true;
+      }, subscription_options);
+
+    rclcpp::ExecutorOptions options;
+    if (tlsf_executor) {
+      options.memory_strategy = std::make_shared<AllocatorMemoryStrategy<Alloc>>(alloc);
+    }
+    executor = std::make_unique<rclcpp::executors::SingleThreadedExecutor>(options);
+    executor->add_node(node);
+  }
+
+  static void * iteration(void * args)
+  {
+    auto self = static_cast<benchmark *>(args);
+    uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+
+    auto ptr = MessageAllocTraits::allocate(self->message_alloc, 1);
+    MessageAllocTraits::construct(self->message_alloc, ptr);
+    MessageUniquePtr msg(ptr, self->message_deleter);
+    self->received = false;
+    msg->data = now_ns();
+    self->publisher->publish(std::move(msg));
+    // Inter-process delivery takes a detour through the middleware; give up after a second.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!self->received && std::chrono::steady_clock::now() < deadline) {
+      self->executor->spin_once(std::chrono::milliseconds(10));
+    }
+
+    rttest_set_column_sample_at(
+      self->latency_column, self->iteration_count, self->received ? self->latency_ns : -1);
+    rttest_set_column_sample_at(
+      self->allocations_column, self->iteration_count,
+      static_cast<int64_t>(g_allocations.load(std::memory_order_relaxed) - allocations));
+    ++self->iteration_count;
+    return nullptr;
+  }
+
+  int run()
+  {
+    latency_column = rttest_add_sample_column("e2e_latency");
+    allocations_column = rttest_add_sample_column("operator_new_calls");
+    if (latency_column < 0 || allocations_column < 0) {
+      return -1;
+    }
+    // Warm up the pipeline outside of the measurement.
+    for (size_t i = 0; i < 10; ++i) {
+      iteration(this);
+    }
+    iteration_count = 0;
+    return rttest_spin(iteration, this);
+  }
+
+  MessageAlloc message_alloc;
+  MessageDeleter message_deleter;
+  typename rclcpp::Publisher<Message, Alloc>::SharedPtr publisher;
+  rclcpp::SubscriptionBase::SharedPtr subscription;
+  std::unique_ptr<rclcpp::executors::SingleThreadedExecutor> executor;
+
+  bool received = false;
+  int64_t latency_ns = 0;
+  size_t iteration_count = 0;
+  int latency_column = -1;
+  int allocations_column = -1;
+};
+
+static void print_column(const char * name, int column)
+{
+  struct rttest_sample_statistics statistics;
+  if (rttest_calculate_column_statistics(column, &statistics) != 0) {
+    return;
+  }
+  printf(
+    "%s: min %lld, max %lld, mean %.1f, stddev %.1f\n", name,
+    static_cast<long long>(statistics.min),  // NOLINT(runtime/int)
+    static_cast<long long>(statistics.max),  // NOLINT(runtime/int)
+    statistics.mean, statistics.stddev);
+}
+
+template<typename Alloc>
+int run_benchmark(rclcpp::Node::SharedPtr node, std::shared_ptr<Alloc> alloc, bool tlsf_executor)
+{
+  benchmark<Alloc> bench(node, alloc, tlsf_executor);
+  if (bench.run() != 0) {
+    return -1;
+  }
+  print_column("End-to-end latency (ns)", bench.latency_column);
+  print_column("Allocations per iteration", bench.allocations_column);
+  return 0;
+}
+
+int main(int argc, char ** argv)
+{
+  std::string allocator = "std";
+  bool intra_process = true;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "std" || arg == "tlsf" || arg == "pool") {
+      allocator = arg;
+    } else if (arg == "intra") {
+      intra_process = true;
+    } else if (arg == "inter") {
+      intra_process = false;
+    }
+  }
+
+  rttest_read_args(argc, argv);
+  rclcpp::init(argc, argv);
+  printf(
+    "Allocator: %s, intra-process pipeline is %s.\n", allocator.c_str(),
+    intra_process ? "ON" : "OFF");
+
+  auto node = rclcpp::Node::make_shared(
+    "allocator_benchmark", rclcpp::NodeOptions().use_intra_process_comms(intra_process));
+
+  if (rttest_lock_and_prefault_dynamic() != 0) {
+    fprintf(stderr, "Couldn't lock all cached virtual memory.\n");
+    fprintf(stderr, "Pagefaults from reading pages not yet mapped into RAM will be recorded.\n");
+  }
+  if (rttest_set_thread_default_priority() != 0) {
+    fprintf(stderr, "Couldn't set the real-time scheduling priority; running without it.\n");
+  }
+
+  int result;
+  if (allocator == "tlsf") {
+    result = run_benchmark(node, std::make_shared<tlsf_heap_allocator<void>>(), true);
+  } else if (allocator == "pool") {
+    tlsf_message_pool<Message> message_pool(16);
+    result = run_benchmark(node, message_pool.get_allocator(), true);
+  } else {
+    result = run_benchmark(node, std::make_shared<std::allocator<void>>(), false);
+  }
+
+  rttest_write_results();
+  rttest_finish();
+  rclcpp::shutdown();
+  return result;
+}
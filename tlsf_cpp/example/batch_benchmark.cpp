@@ -0,0 +1,96 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-element cost of allocating and freeing blocks one at a time versus in batches.
+//
+// For several batch sizes, every round allocates a batch of blocks and frees it again, either
+// with one allocate and deallocate call per block or with allocate_batch and deallocate_batch.
+// The reported figure is the time per block for one allocation plus one deallocation.
+//
+// Usage: tlsf_batch_benchmark [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+namespace
+{
+
+constexpr size_t block_size = 96;
+
+template<typename Pool>
+double single_ns(Pool & pool, std::vector<void *> & blocks, size_t rounds)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (auto & block : blocks) {
+      block = pool.allocate(block_size);
+    }
+    for (auto block : blocks) {
+      pool.deallocate(block, block_size);
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - start).count();
+  return elapsed / static_cast<double>(rounds * blocks.size());
+}
+
+template<typename Pool>
+double batch_ns(Pool & pool, std::vector<void *> & blocks, size_t rounds)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    if (!pool.allocate_batch(blocks.data(), blocks.size(), block_size)) {
+      fprintf(stderr, "Pool exhausted\n");
+      abort();
+    }
+    pool.deallocate_batch(blocks.data(), blocks.size(), block_size);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - start).count();
+  return elapsed / static_cast<double>(rounds * blocks.size());
+}
+
+template<typename LockPolicy>
+void run(const char * name, size_t rounds)
+{
+  basic_tlsf_pool<LockPolicy> pool(1024 * 1024);
+  for (size_t batch : {1, 4, 16, 64, 256}) {
+    std::vector<void *> blocks(batch);
+    size_t batch_rounds = rounds / batch + 1;
+    // Warm up the pool and the caches before measuring.
+    single_ns(pool, blocks, batch_rounds / 10 + 1);
+    double single = single_ns(pool, blocks, batch_rounds);
+    double batched = batch_ns(pool, blocks, batch_rounds);
+    printf(
+      "%-14s %6zu %12.1f %12.1f %8.2f\n", name, batch, single, batched, single / batched);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  printf(
+    "%-14s %6s %12s %12s %8s\n", "lock", "batch", "single_ns", "batch_ns", "speedup");
+  run<tlsf_no_lock>("no_lock", rounds);
+  run<tlsf_pi_mutex>("pi_mutex", rounds);
+  run<tlsf_ticket_spinlock>("ticket_spin", rounds);
+  return 0;
+}
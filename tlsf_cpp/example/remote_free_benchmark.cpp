@@ -0,0 +1,127 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Producer/consumer benchmark of cross-thread deallocation.
+//
+// A producer thread allocates messages from a TLSF pool and hands them to a consumer thread
+// through a ring buffer; the consumer frees them. Three setups are compared:
+//
+//   locked         a pool with tlsf_pi_mutex; the consumer frees under the lock.
+//   locked_remote  the same pool owned by the producer; the consumer queues its frees.
+//   remote         an unsynchronized pool owned by the producer; the consumer queues its frees.
+//
+// Usage: tlsf_remote_free_benchmark [message_count]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+namespace
+{
+
+constexpr size_t ring_size = 256;
+
+struct message_ring
+{
+  message_ring()
+  {
+    for (auto & slot : slots) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<void *> slots[ring_size];
+};
+
+template<typename LockPolicy>
+void run(const char * name, size_t message_count, bool remote)
+{
+  basic_tlsf_pool<LockPolicy> pool(4 * 1024 * 1024);
+  pool.enable_latency_histograms(true);
+  message_ring ring;
+  std::atomic<bool> ready{false};
+
+  std::thread consumer([&]() {
+      while (!ready.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (size_t i = 0; i < message_count; ++i) {
+        void * message;
+        while ((message = ring.slots[i % ring_size].exchange(
+            nullptr, std::memory_order_acquire)) == nullptr)
+        {
+          std::this_thread::yield();
+        }
+        pool.deallocate(message, 64 + (i % 16) * 32);
+      }
+    });
+
+  std::thread producer([&]() {
+      if (remote) {
+        pool.set_owner_thread();
+      }
+      ready.store(true, std::memory_order_release);
+      for (size_t i = 0; i < message_count; ++i) {
+        void * message = pool.allocate(64 + (i % 16) * 32);
+        if (message == nullptr) {
+          fprintf(stderr, "%s: pool exhausted\n", name);
+          abort();
+        }
+        auto & slot = ring.slots[i % ring_size];
+        while (slot.load(std::memory_order_relaxed) != nullptr) {
+          std::this_thread::yield();
+        }
+        slot.store(message, std::memory_order_release);
+      }
+    });
+
+  auto start = std::chrono::steady_clock::now();
+  producer.join();
+  consumer.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  auto stats = pool.stats();
+  printf(
+    "%-14s %10.0f %10llu %10llu %10llu %10llu %10llu %10llu\n", name,
+    static_cast<double>(message_count) / seconds,
+    static_cast<unsigned long long>(  // NOLINT(runtime/int)
+      stats.allocate_latency.percentile_upper_bound_ns(0.5)),
+    static_cast<unsigned long long>(  // NOLINT(runtime/int)
+      stats.allocate_latency.percentile_upper_bound_ns(0.99)),
+    static_cast<unsigned long long>(stats.allocate_latency.max_ns),  // NOLINT(runtime/int)
+    static_cast<unsigned long long>(  // NOLINT(runtime/int)
+      stats.deallocate_latency.percentile_upper_bound_ns(0.99)),
+    static_cast<unsigned long long>(stats.deallocate_latency.max_ns),  // NOLINT(runtime/int)
+    static_cast<unsigned long long>(stats.lock.contended_acquisitions));  // NOLINT(runtime/int)
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t message_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  printf(
+    "%-14s %10s %10s %10s %10s %10s %10s %10s\n", "setup", "msgs/s", "alloc_p50",
+    "alloc_p99", "alloc_max", "free_p99", "free_max", "contended");
+  run<tlsf_pi_mutex>("locked", message_count, false);
+  run<tlsf_pi_mutex>("locked_remote", message_count, true);
+  run<tlsf_no_lock>("remote", message_count, true);
+  return 0;
+}
@@ -0,0 +1,72 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Query interface of the tlsf_cpp_global library.
+//
+// Linking against tlsf_cpp_global, or preloading it with LD_PRELOAD, replaces malloc, free
+// and friends as well as the global operator new and delete with a single TLSF pool guarded
+// by a priority-inheriting mutex. The pool is created on the first allocation of the process
+// and configured through the environment:
+//
+//   TLSF_CPP_GLOBAL_POOL_SIZE  Pool size in bytes, or with a kb, mb or gb suffix. Default 64mb,
+//                              also used if the size is malformed or does not fit in size_t.
+//   TLSF_CPP_GLOBAL_POOL_LOCK  If set to 0, do not mlock and prefault the pool.
+//
+// Requests the pool cannot satisfy fall back to the glibc allocator and are counted, so the
+// pool can be sized from the fallback statistics. When rttest is linked into the process, every
+// allocation and deallocation is also reported to its per-iteration allocator columns.
+
+#ifndef TLSF_CPP__GLOBAL_ALLOCATOR_H_
+#define TLSF_CPP__GLOBAL_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct tlsf_global_stats
+{
+  size_t pool_size;
+  // Whether the pool memory was locked into RAM with mlock.
+  int pool_locked;
+
+  uint64_t pool_allocations;
+  uint64_t pool_deallocations;
+  // Bytes requested from the pool and not yet freed.
+  size_t pool_bytes_in_use;
+  size_t pool_peak_bytes_in_use;
+
+  // Requests served by the glibc allocator because the pool was exhausted.
+  uint64_t fallback_allocations;
+  uint64_t fallback_deallocations;
+  size_t fallback_bytes;
+};
+
+/// \brief Fill in the statistics of the global TLSF pool.
+/// \param[out] stats The struct to fill in.
+/// \return 0 on success, -1 if stats is NULL.
+int tlsf_global_get_stats(struct tlsf_global_stats * stats);
+
+/// \brief Check whether a pointer was allocated from the global TLSF pool.
+/// \return 1 if it was, 0 if it came from the fallback allocator or elsewhere.
+int tlsf_global_owns(const void * ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TLSF_CPP__GLOBAL_ALLOCATOR_H_
@@ -18,60 +18,150 @@
 #ifndef TLSF_CPP__TLSF_HPP_
 #define TLSF_CPP__TLSF_HPP_
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <new>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 
 #include "tlsf/tlsf.h"
+#include "tlsf_cpp/tlsf_allocator_hooks.hpp"
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_registry.hpp"
 
-template<typename T, size_t DefaultPoolSize = 1024 * 1024>
+// LockPolicy selects how the pool is synchronized when the allocator is shared between
+// threads, e.g. by a MultiThreadedExecutor; see tlsf_lock_policy.hpp.
+template<typename T, size_t DefaultPoolSize = 1024 * 1024, typename LockPolicy = tlsf_no_lock>
 struct tlsf_heap_allocator
 {
   // Needed for std::allocator_traits
   using value_type = T;
 
+  using pool_type = basic_tlsf_pool<LockPolicy>;
+
   explicit tlsf_heap_allocator(size_t size)
-  : memory_pool(nullptr), pool_size(size)
+  : pool(nullptr), memory_pool(nullptr), pool_size(size)
   {
     initialize(size);
   }
 
   // Needed for std::allocator_traits
+  // With a lock policy, binds to the registry's default pool if its size is configured, e.g.
+  // with TLSF_CPP_POOLS, and creates a pool of DefaultPoolSize bytes otherwise. Without a lock
+  // the pool is always private, as nothing keeps the users of a shared one in one thread.
+  // Throws std::logic_error if the default pool is in use with another lock policy.
   tlsf_heap_allocator()
-  : memory_pool(nullptr)
+  : pool(nullptr), memory_pool(nullptr)
   {
-    initialize(DefaultPoolSize);
+    auto & registry = tlsf_pool_registry::instance();
+    if (!std::is_same<LockPolicy, tlsf_no_lock>::value &&
+      registry.is_configured(tlsf_pool_registry::default_pool_name))
+    {
+      bind(registry.acquire<LockPolicy>(tlsf_pool_registry::default_pool_name));
+    } else {
+      initialize(DefaultPoolSize);
+    }
   }
 
-  // Needed for std::allocator_traits
-  template<typename U>
-  tlsf_heap_allocator(const tlsf_heap_allocator<U> & alloc)
-  : memory_pool(alloc.memory_pool), pool_size(alloc.pool_size)
+  // Allocate from a pool of the registry, of DefaultPoolSize bytes unless configured otherwise.
+  // Throws std::logic_error if the pool is in use with another lock policy.
+  explicit tlsf_heap_allocator(const std::string & pool_name)
+  : pool(nullptr), memory_pool(nullptr)
+  {
+    bind(tlsf_pool_registry::instance().acquire<LockPolicy>(pool_name, DefaultPoolSize));
+  }
+
+  // Allocate from an existing pool instead of creating a new one. Does not allocate, so an
+  // allocator over a static_tlsf_pool, or a pool over a caller-supplied buffer, never touches
+  // the heap.
+  explicit tlsf_heap_allocator(pool_type & existing_pool)
+  : pool(&existing_pool), memory_pool(existing_pool.data()), pool_size(existing_pool.size())
+  {
+    pool->retain();
+  }
+
+  tlsf_heap_allocator(const tlsf_heap_allocator & alloc)
+  : pool(alloc.pool), memory_pool(alloc.memory_pool), pool_size(alloc.pool_size),
+    client_(alloc.client_)
   {
+    if (pool) {
+      pool->retain();
+    }
   }
 
+  // Needed for std::allocator_traits
   template<typename U, size_t OtherDefaultSize>
-  tlsf_heap_allocator(const tlsf_heap_allocator<U> & alloc)
-  : memory_pool(alloc.memory_pool), pool_size(alloc.pool_size)
+  tlsf_heap_allocator(const tlsf_heap_allocator<U, OtherDefaultSize, LockPolicy> & alloc)
+  : pool(alloc.pool), memory_pool(alloc.memory_pool), pool_size(alloc.pool_size),
+    client_(alloc.client_)
+  {
+    if (pool) {
+      pool->retain();
+    }
+  }
+
+  tlsf_heap_allocator & operator=(const tlsf_heap_allocator & alloc)
   {
+    if (alloc.pool) {
+      alloc.pool->retain();
+    }
+    if (pool) {
+      pool->release();
+    }
+    pool = alloc.pool;
+    memory_pool = alloc.memory_pool;
+    pool_size = alloc.pool_size;
+    client_ = alloc.client_;
+    return *this;
+  }
+
+  // Charge the allocations made through this allocator, and through the copies made from it
+  // afterwards, to a client of the pool, see basic_tlsf_pool::charge_client. Allocations over
+  // the quota of the client throw std::bad_alloc. Memory must be released through an allocator
+  // of the same client. Throws std::out_of_range for IDs the pool cannot track; 0 untags.
+  tlsf_heap_allocator & set_client(uint32_t id)
+  {
+    if (id != 0) {
+      pool->client_stats(id);
+    }
+    client_ = id;
+    return *this;
+  }
+
+  uint32_t client() const noexcept
+  {
+    return client_;
   }
 
   size_t initialize(size_t size)
   {
     pool_size = size;
     if (!memory_pool) {
-      memory_pool = new char[pool_size];
-      memset(memory_pool, 0, pool_size);
-      init_memory_pool(pool_size, memory_pool);
+      pool = pool_type::create(pool_size);
+      memory_pool = pool->data();
     }
     return pool_size;
   }
 
+  // Take over a reference to a pool acquired from the registry.
+  void bind(pool_type & acquired_pool)
+  {
+    pool = &acquired_pool;
+    memory_pool = pool->data();
+    pool_size = pool->size();
+  }
+
+  // The pool is shared between all copies of the allocator and destroyed with the last one.
   ~tlsf_heap_allocator()
   {
-    if (memory_pool) {
-      destroy_memory_pool(memory_pool);
+    if (pool) {
+      pool->release();
+      pool = nullptr;
       memory_pool = nullptr;
     }
   }
@@ -79,27 +169,132 @@ struct tlsf_heap_allocator
   // Needed for std::allocator_traits
   T * allocate(size_t size)
   {
-    T * ptr = static_cast<T *>(tlsf_malloc(size * sizeof(T)));
+    return allocate_aligned(size, alignof(T));
+  }
+
+  // Needed for std::allocator_traits
+  void deallocate(T * ptr, size_t size)
+  {
+    deallocate_aligned(ptr, size, alignof(T));
+  }
+
+  // Allocate storage for size objects, aligned to at least the given alignment.
+  // The alignment must be a power of two; it is raised to alignof(T) if smaller.
+  T * allocate_aligned(size_t size, size_t alignment)
+  {
+    if (!tlsf_cpp::detail::is_power_of_two(alignment)) {
+      throw std::invalid_argument("tlsf_heap_allocator: alignment must be a power of two");
+    }
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    if (!pool->charge_client(client_, size * sizeof(T))) {
+      throw std::bad_alloc();
+    }
+    T * ptr = tlsf_cpp::detail::report_allocation(
+      1, size * sizeof(T), [&]() {
+        return static_cast<T *>(pool->allocate(size * sizeof(T), std::max(alignment, alignof(T))));
+      });
     if (ptr == NULL && size > 0) {
+      pool->credit_client(client_, size * sizeof(T));
       throw std::bad_alloc();
     }
     return ptr;
   }
 
-  // Needed for std::allocator_traits
-  void deallocate(T * ptr, size_t)
+  // Release storage obtained from allocate_aligned with the same size and alignment.
+  void deallocate_aligned(T * ptr, size_t size, size_t alignment)
+  {
+    tlsf_cpp::detail::report_deallocation(
+      1, [&]() {pool->deallocate(ptr, size * sizeof(T), std::max(alignment, alignof(T)));});
+    if (ptr != nullptr) {
+      pool->credit_client(client_, size * sizeof(T));
+    }
+  }
+
+  // Resize an array obtained from this allocator, in place when the pool can extend or shrink
+  // it, see basic_tlsf_pool::reallocate. Objects are moved with memcpy, so T must be trivially
+  // copyable. Throws std::bad_alloc, leaving the array untouched, if the pool is exhausted.
+  T * reallocate(T * ptr, size_t old_size, size_t new_size)
+  {
+    static_assert(
+      std::is_trivially_copyable<T>::value,
+      "tlsf_heap_allocator::reallocate needs a trivially copyable type");
+    if (new_size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    size_t old_bytes = ptr != nullptr ? old_size * sizeof(T) : 0;
+    size_t new_bytes = new_size * sizeof(T);
+    if (new_bytes > old_bytes && !pool->charge_client(client_, new_bytes - old_bytes)) {
+      throw std::bad_alloc();
+    }
+    T * resized = static_cast<T *>(
+      pool->reallocate(ptr, old_size * sizeof(T), new_bytes, alignof(T)));
+    if (resized == nullptr && new_size > 0) {
+      pool->credit_client(client_, new_bytes - std::min(old_bytes, new_bytes));
+      throw std::bad_alloc();
+    }
+    if (new_bytes < old_bytes) {
+      pool->credit_client(client_, old_bytes - new_bytes);
+    }
+    return resized;
+  }
+
+  // Allocate count arrays of size objects each, taking the pool lock once for all of them.
+  // Either every pointer is filled in or std::bad_alloc is thrown.
+  void allocate_batch(T ** ptrs, size_t count, size_t size = 1)
+  {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    if (!pool->charge_client(client_, count * size * sizeof(T))) {
+      throw std::bad_alloc();
+    }
+    bool allocated = tlsf_cpp::detail::report_allocation(
+      count, count * size * sizeof(T), [&]() {
+        return pool->allocate_batch(
+          reinterpret_cast<void **>(ptrs), count, size * sizeof(T), alignof(T));
+      });
+    if (!allocated) {
+      pool->credit_client(client_, count * size * sizeof(T));
+      throw std::bad_alloc();
+    }
+  }
+
+  // Release arrays obtained from allocate_batch, or from allocate with the same size.
+  void deallocate_batch(T * const * ptrs, size_t count, size_t size = 1)
   {
-    tlsf_free(ptr);
+    tlsf_cpp::detail::report_deallocation(
+      count, [&]() {
+        pool->deallocate_batch(
+          reinterpret_cast<void * const *>(ptrs), count, size * sizeof(T), alignof(T));
+      });
+    if (client_ != 0) {
+      size_t released = 0;
+      for (size_t i = 0; i < count; ++i) {
+        released += ptrs[i] != nullptr ? size * sizeof(T) : 0;
+      }
+      pool->credit_client(client_, released);
+    }
   }
 
   template<typename U>
   struct rebind
   {
-    typedef tlsf_heap_allocator<U> other;
+    typedef tlsf_heap_allocator<U, DefaultPoolSize, LockPolicy> other;
   };
 
+  pool_type * pool;
   char * memory_pool;
   size_t pool_size;
+
+private:
+  template<typename, size_t, typename>
+  friend struct tlsf_heap_allocator;
+
+  // Client of the pool the allocations are charged to; 0 if untagged. Only set through
+  // set_client(), which checks it against the pool.
+  uint32_t client_ = 0;
 };
 
 // Needed for std::allocator_traits
@@ -120,19 +315,19 @@ constexpr bool operator!=(
   return a.memory_pool != b.memory_pool;
 }
 
-template<typename T, typename U, size_t X, size_t Y>
+template<typename T, typename U, size_t X, size_t Y, typename L>
 constexpr bool operator==(
-  const tlsf_heap_allocator<T, X> & a,
-  const tlsf_heap_allocator<U, Y> & b) noexcept
+  const tlsf_heap_allocator<T, X, L> & a,
+  const tlsf_heap_allocator<U, Y, L> & b) noexcept
 {
   return a.memory_pool == b.memory_pool;
 }
 
 // Needed for std::allocator_traits
-template<typename T, typename U, size_t X, size_t Y>
+template<typename T, typename U, size_t X, size_t Y, typename L>
 constexpr bool operator!=(
-  const tlsf_heap_allocator<T, X> & a,
-  const tlsf_heap_allocator<U, Y> & b) noexcept
+  const tlsf_heap_allocator<T, X, L> & a,
+  const tlsf_heap_allocator<U, Y, L> & b) noexcept
 {
   return a.memory_pool != b.memory_pool;
 }
@@ -0,0 +1,83 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reporting of allocator calls to rttest, which records them per iteration next to the
+// pagefaults.
+//
+// The hooks are declared weak: they resolve to the rttest functions when rttest is linked into
+// the process and to null otherwise, in which case allocators skip the reporting, clock reads
+// included. tlsf_cpp does not depend on rttest for this.
+
+#ifndef TLSF_CPP__TLSF_ALLOCATOR_HOOKS_HPP_
+#define TLSF_CPP__TLSF_ALLOCATOR_HOOKS_HPP_
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+// Defined in rttest, see rttest/rttest.h.
+void rttest_allocator_hook_allocate(size_t count, size_t bytes, uint64_t duration_ns)
+__attribute__((weak));
+void rttest_allocator_hook_deallocate(size_t count, uint64_t duration_ns)
+__attribute__((weak));
+}
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+inline uint64_t hook_clock_ns() noexcept
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// Run allocate(), which returns a pointer or whether it succeeded, and report the blocks if
+// it did.
+template<typename Allocate>
+auto report_allocation(size_t count, size_t bytes, Allocate && allocate)
+{
+  if (rttest_allocator_hook_allocate == nullptr) {
+    return allocate();
+  }
+  uint64_t start = hook_clock_ns();
+  auto result = allocate();
+  if (result) {
+    rttest_allocator_hook_allocate(count, bytes, hook_clock_ns() - start);
+  }
+  return result;
+}
+
+// Run deallocate() and report count freed blocks.
+template<typename Deallocate>
+void report_deallocation(size_t count, Deallocate && deallocate)
+{
+  if (rttest_allocator_hook_deallocate == nullptr) {
+    deallocate();
+    return;
+  }
+  uint64_t start = hook_clock_ns();
+  deallocate();
+  rttest_allocator_hook_deallocate(count, hook_clock_ns() - start);
+}
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+#endif  // TLSF_CPP__TLSF_ALLOCATOR_HOOKS_HPP_
@@ -0,0 +1,185 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A growable buffer of trivially copyable elements that resizes its TLSF block in place
+// whenever the pool allows it, e.g. for serialized messages of varying size.
+
+#ifndef TLSF_CPP__TLSF_BUFFER_HPP_
+#define TLSF_CPP__TLSF_BUFFER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "tlsf_cpp/tlsf.hpp"
+
+/// Contiguous, growable storage for trivially copyable elements.
+/**
+ * Unlike std::vector, which allocates, copies and frees on every growth, the buffer asks the
+ * allocator to extend its block first. TLSF does so in place when the memory behind the block
+ * is free, which avoids the copy and the moment where both blocks are held at once.
+ * Alloc must provide reallocate() like tlsf_heap_allocator.
+ *
+ * Growth is geometric, so that appending stays amortized constant time when the block has to
+ * move. Elements are not initialized by resize().
+ */
+template<typename T, typename Alloc = tlsf_heap_allocator<T>>
+class tlsf_buffer
+{
+  static_assert(
+    std::is_trivially_copyable<T>::value, "tlsf_buffer needs a trivially copyable type");
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  explicit tlsf_buffer(const Alloc & alloc = Alloc())
+  : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
+  {
+  }
+
+  /// Not real time safe.
+  explicit tlsf_buffer(size_t capacity, const Alloc & alloc = Alloc())
+  : tlsf_buffer(alloc)
+  {
+    reserve(capacity);
+  }
+
+  tlsf_buffer(const tlsf_buffer &) = delete;
+  tlsf_buffer & operator=(const tlsf_buffer &) = delete;
+
+  tlsf_buffer(tlsf_buffer && other) noexcept
+  : alloc_(other.alloc_), data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+  {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+
+  ~tlsf_buffer()
+  {
+    if (data_ != nullptr) {
+      alloc_.deallocate(data_, capacity_);
+    }
+  }
+
+  T * data() noexcept {return data_;}
+  const T * data() const noexcept {return data_;}
+  size_t size() const noexcept {return size_;}
+  size_t capacity() const noexcept {return capacity_;}
+  bool empty() const noexcept {return size_ == 0;}
+
+  T & operator[](size_t index) noexcept {return data_[index];}
+  const T & operator[](size_t index) const noexcept {return data_[index];}
+
+  iterator begin() noexcept {return data_;}
+  iterator end() noexcept {return data_ + size_;}
+  const_iterator begin() const noexcept {return data_;}
+  const_iterator end() const noexcept {return data_ + size_;}
+
+  allocator_type get_allocator() const
+  {
+    return alloc_;
+  }
+
+  /// Make room for at least capacity elements, extending the block in place if possible.
+  /// \throws std::bad_alloc if the pool cannot hold them; the buffer is then unchanged.
+  void reserve(size_t capacity)
+  {
+    if (capacity > capacity_) {
+      reallocate(capacity);
+    }
+  }
+
+  /// Change the number of elements; new elements are left uninitialized.
+  void resize(size_t size)
+  {
+    if (size > capacity_) {
+      reallocate(grown_capacity(size));
+    }
+    size_ = size;
+  }
+
+  void push_back(const T & value)
+  {
+    if (size_ == capacity_) {
+      // value may live in the buffer itself.
+      T copy = value;
+      reallocate(grown_capacity(size_ + 1));
+      data_[size_++] = copy;
+      return;
+    }
+    data_[size_++] = value;
+  }
+
+  /// Append count elements, which must not come from this buffer.
+  void append(const T * values, size_t count)
+  {
+    if (count > capacity_ - size_) {
+      if (count > std::numeric_limits<size_t>::max() - size_) {
+        throw std::bad_array_new_length();
+      }
+      reallocate(grown_capacity(size_ + count));
+    }
+    if (count > 0) {
+      memcpy(data_ + size_, values, count * sizeof(T));
+    }
+    size_ += count;
+  }
+
+  void clear() noexcept
+  {
+    size_ = 0;
+  }
+
+  /// Give the unused capacity back to the pool; TLSF shrinks blocks in place.
+  void shrink_to_fit()
+  {
+    if (capacity_ == size_) {
+      return;
+    }
+    if (size_ == 0) {
+      alloc_.deallocate(data_, capacity_);
+      data_ = nullptr;
+      capacity_ = 0;
+      return;
+    }
+    reallocate(size_);
+  }
+
+private:
+  size_t grown_capacity(size_t required) const noexcept
+  {
+    return std::max(required, capacity_ + capacity_ / 2);
+  }
+
+  void reallocate(size_t capacity)
+  {
+    data_ = alloc_.reallocate(data_, capacity_, capacity);
+    capacity_ = capacity;
+  }
+
+  Alloc alloc_;
+  T * data_;
+  size_t size_;
+  size_t capacity_;
+};
+
+#endif  // TLSF_CPP__TLSF_BUFFER_HPP_
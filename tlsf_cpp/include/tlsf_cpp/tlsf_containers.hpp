@@ -0,0 +1,822 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Fixed-capacity containers for real-time loops. Each one takes its capacity at construction,
+// reserves it from a TLSF pool right away, and throws std::length_error when an operation
+// would grow it past that capacity, instead of allocating.
+
+#ifndef TLSF_CPP__TLSF_CONTAINERS_HPP_
+#define TLSF_CPP__TLSF_CONTAINERS_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tlsf_cpp/tlsf.hpp"
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+inline void check_capacity(const char * container, size_t required, size_t capacity)
+{
+  if (required > capacity) {
+    throw std::length_error(
+            std::string(container) + ": capacity of " + std::to_string(capacity) + " exceeded");
+  }
+}
+
+}  // namespace detail
+
+namespace rt
+{
+
+/// std::vector that never reallocates.
+/**
+ * The capacity is reserved at construction. Operations that would need more elements throw
+ * std::length_error and leave the vector unchanged.
+ */
+template<typename T, typename Alloc = tlsf_heap_allocator<T>>
+class vector : private std::vector<T, Alloc>
+{
+  using base = std::vector<T, Alloc>;
+
+public:
+  using typename base::value_type;
+  using typename base::allocator_type;
+  using typename base::size_type;
+  using typename base::difference_type;
+  using typename base::reference;
+  using typename base::const_reference;
+  using typename base::pointer;
+  using typename base::const_pointer;
+  using typename base::iterator;
+  using typename base::const_iterator;
+  using typename base::reverse_iterator;
+  using typename base::const_reverse_iterator;
+
+  /// Not real time safe.
+  explicit vector(size_t capacity, const Alloc & alloc = Alloc())
+  : base(alloc), capacity_(capacity)
+  {
+    base::reserve(capacity);
+  }
+
+  vector(const vector & other)
+  : vector(other.capacity_, other.get_allocator())
+  {
+    base::assign(other.begin(), other.end());
+  }
+
+  // The moved-from vector is left without capacity.
+  vector(vector && other) noexcept
+  : base(std::move(other)), capacity_(other.capacity_)
+  {
+    other.capacity_ = 0;
+  }
+
+  vector & operator=(const vector & other)
+  {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  // Moves the elements, the storage stays with each vector.
+  vector & operator=(vector && other)
+  {
+    if (this != &other) {
+      assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+      other.clear();
+    }
+    return *this;
+  }
+
+  using base::get_allocator;
+  using base::at;
+  using base::operator[];
+  using base::front;
+  using base::back;
+  using base::data;
+  using base::begin;
+  using base::cbegin;
+  using base::end;
+  using base::cend;
+  using base::rbegin;
+  using base::crbegin;
+  using base::rend;
+  using base::crend;
+  using base::empty;
+  using base::size;
+  using base::clear;
+  using base::erase;
+  using base::pop_back;
+
+  size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  bool full() const noexcept
+  {
+    return size() == capacity_;
+  }
+
+  void push_back(const T & value)
+  {
+    check(size() + 1);
+    base::push_back(value);
+  }
+
+  void push_back(T && value)
+  {
+    check(size() + 1);
+    base::push_back(std::move(value));
+  }
+
+  template<typename ... Args>
+  reference emplace_back(Args && ... args)
+  {
+    check(size() + 1);
+    return base::emplace_back(std::forward<Args>(args)...);
+  }
+
+  template<typename ... Args>
+  iterator emplace(const_iterator pos, Args && ... args)
+  {
+    check(size() + 1);
+    return base::emplace(pos, std::forward<Args>(args)...);
+  }
+
+  iterator insert(const_iterator pos, const T & value)
+  {
+    check(size() + 1);
+    return base::insert(pos, value);
+  }
+
+  iterator insert(const_iterator pos, T && value)
+  {
+    check(size() + 1);
+    return base::insert(pos, std::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_t count, const T & value)
+  {
+    check(size() + count);
+    return base::insert(pos, count, value);
+  }
+
+  /// Insert a range given by forward iterators.
+  template<typename ForwardIt, typename = std::enable_if_t<!std::is_integral<ForwardIt>::value>>
+  iterator insert(const_iterator pos, ForwardIt first, ForwardIt last)
+  {
+    check(size() + static_cast<size_t>(std::distance(first, last)));
+    return base::insert(pos, first, last);
+  }
+
+  void resize(size_t count)
+  {
+    check(count);
+    base::resize(count);
+  }
+
+  void resize(size_t count, const T & value)
+  {
+    check(count);
+    base::resize(count, value);
+  }
+
+  void assign(size_t count, const T & value)
+  {
+    check(count);
+    base::assign(count, value);
+  }
+
+  /// Replace the contents with a range given by forward iterators.
+  template<typename ForwardIt, typename = std::enable_if_t<!std::is_integral<ForwardIt>::value>>
+  void assign(ForwardIt first, ForwardIt last)
+  {
+    check(static_cast<size_t>(std::distance(first, last)));
+    base::assign(first, last);
+  }
+
+private:
+  void check(size_t required) const
+  {
+    tlsf_cpp::detail::check_capacity("rt::vector", required, capacity_);
+  }
+
+  size_t capacity_;
+};
+
+/// std::basic_string that never reallocates.
+/**
+ * The capacity, not counting the terminating null character, is reserved at construction.
+ * Operations that would make the string longer throw std::length_error and leave it unchanged.
+ * Operations that return a new string are left out; use str() or view() to read it.
+ */
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+  typename Alloc = tlsf_heap_allocator<CharT>>
+class basic_string : private std::basic_string<CharT, Traits, Alloc>
+{
+  using base = std::basic_string<CharT, Traits, Alloc>;
+
+public:
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using typename base::traits_type;
+  using typename base::value_type;
+  using typename base::allocator_type;
+  using typename base::size_type;
+  using typename base::difference_type;
+  using typename base::reference;
+  using typename base::const_reference;
+  using typename base::pointer;
+  using typename base::const_pointer;
+  using typename base::iterator;
+  using typename base::const_iterator;
+  using base::npos;
+
+  /// Not real time safe.
+  explicit basic_string(size_t capacity, const Alloc & alloc = Alloc())
+  : base(alloc), capacity_(capacity)
+  {
+    base::reserve(capacity);
+  }
+
+  /// Not real time safe.
+  basic_string(size_t capacity, view_type value, const Alloc & alloc = Alloc())
+  : basic_string(capacity, alloc)
+  {
+    assign(value);
+  }
+
+  basic_string(const basic_string & other)
+  : basic_string(other.capacity_, other.view(), other.get_allocator())
+  {
+  }
+
+  // The moved-from string is left without capacity.
+  basic_string(basic_string && other) noexcept
+  : base(std::move(other)), capacity_(other.capacity_)
+  {
+    other.capacity_ = 0;
+  }
+
+  basic_string & operator=(const basic_string & other)
+  {
+    if (this != &other) {
+      assign(other.view());
+    }
+    return *this;
+  }
+
+  basic_string & operator=(view_type value)
+  {
+    return assign(value);
+  }
+
+  using base::get_allocator;
+  using base::at;
+  using base::operator[];
+  using base::front;
+  using base::back;
+  using base::data;
+  using base::c_str;
+  using base::begin;
+  using base::cbegin;
+  using base::end;
+  using base::cend;
+  using base::empty;
+  using base::size;
+  using base::length;
+  using base::clear;
+  using base::pop_back;
+  using base::erase;
+  using base::find;
+  using base::rfind;
+  using base::compare;
+
+  size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  const base & str() const noexcept
+  {
+    return *this;
+  }
+
+  view_type view() const noexcept
+  {
+    return view_type(data(), size());
+  }
+
+  operator view_type() const noexcept
+  {
+    return view();
+  }
+
+  void push_back(CharT c)
+  {
+    check(size() + 1);
+    base::push_back(c);
+  }
+
+  basic_string & append(view_type value)
+  {
+    check(size() + value.size());
+    base::append(value.data(), value.size());
+    return *this;
+  }
+
+  basic_string & append(size_t count, CharT c)
+  {
+    check(size() + count);
+    base::append(count, c);
+    return *this;
+  }
+
+  basic_string & operator+=(view_type value)
+  {
+    return append(value);
+  }
+
+  basic_string & operator+=(CharT c)
+  {
+    push_back(c);
+    return *this;
+  }
+
+  basic_string & insert(size_t index, view_type value)
+  {
+    check(size() + value.size());
+    base::insert(index, value.data(), value.size());
+    return *this;
+  }
+
+  basic_string & assign(view_type value)
+  {
+    check(value.size());
+    base::assign(value.data(), value.size());
+    return *this;
+  }
+
+  basic_string & replace(size_t pos, size_t count, view_type value)
+  {
+    size_t removed = std::min(count, size() - std::min(pos, size()));
+    check(size() - removed + value.size());
+    base::replace(pos, count, value.data(), value.size());
+    return *this;
+  }
+
+  void resize(size_t count, CharT c = CharT())
+  {
+    check(count);
+    base::resize(count, c);
+  }
+
+private:
+  void check(size_t required) const
+  {
+    tlsf_cpp::detail::check_capacity("rt::basic_string", required, capacity_);
+  }
+
+  size_t capacity_;
+};
+
+template<typename CharT, typename Traits, typename Alloc>
+bool operator==(
+  const basic_string<CharT, Traits, Alloc> & a, std::basic_string_view<CharT, Traits> b) noexcept
+{
+  return a.view() == b;
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+bool operator!=(
+  const basic_string<CharT, Traits, Alloc> & a, std::basic_string_view<CharT, Traits> b) noexcept
+{
+  return a.view() != b;
+}
+
+using string = basic_string<char>;
+
+/// std::unordered_map that never rehashes and holds at most a fixed number of elements.
+/**
+ * The buckets for capacity elements are reserved at construction; nodes are allocated from
+ * the pool one at a time as elements are inserted, so size the pool for them too.
+ * Inserting a new key into a full map throws std::length_error and leaves it unchanged.
+ * Only insertions that know the key up front are provided.
+ */
+template<typename Key, typename T, typename Hash = std::hash<Key>,
+  typename KeyEqual = std::equal_to<Key>,
+  typename Alloc = tlsf_heap_allocator<std::pair<const Key, T>>>
+class unordered_map : private std::unordered_map<Key, T, Hash, KeyEqual, Alloc>
+{
+  using base = std::unordered_map<Key, T, Hash, KeyEqual, Alloc>;
+
+public:
+  using typename base::key_type;
+  using typename base::mapped_type;
+  using typename base::value_type;
+  using typename base::allocator_type;
+  using typename base::size_type;
+  using typename base::hasher;
+  using typename base::key_equal;
+  using typename base::reference;
+  using typename base::const_reference;
+  using typename base::iterator;
+  using typename base::const_iterator;
+
+  /// Not real time safe.
+  explicit unordered_map(size_t capacity, const Alloc & alloc = Alloc())
+  : base(0, Hash(), KeyEqual(), alloc), capacity_(capacity)
+  {
+    base::reserve(capacity);
+  }
+
+  unordered_map(const unordered_map & other)
+  : unordered_map(other.capacity_, other.get_allocator())
+  {
+    base::insert(other.begin(), other.end());
+  }
+
+  // The moved-from map is left without capacity.
+  unordered_map(unordered_map && other) noexcept
+  : base(std::move(other)), capacity_(other.capacity_)
+  {
+    other.capacity_ = 0;
+  }
+
+  unordered_map & operator=(const unordered_map & other)
+  {
+    if (this != &other) {
+      check(other.size());
+      base::clear();
+      base::insert(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  using base::get_allocator;
+  using base::begin;
+  using base::cbegin;
+  using base::end;
+  using base::cend;
+  using base::empty;
+  using base::size;
+  using base::clear;
+  using base::erase;
+  using base::find;
+  using base::count;
+  using base::at;
+  using base::bucket_count;
+  using base::load_factor;
+
+  size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  std::pair<iterator, bool> insert(const value_type & value)
+  {
+    check_new_key(value.first);
+    return base::insert(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type && value)
+  {
+    check_new_key(value.first);
+    return base::insert(std::move(value));
+  }
+
+  template<typename ... Args>
+  std::pair<iterator, bool> try_emplace(const Key & key, Args && ... args)
+  {
+    check_new_key(key);
+    return base::try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  template<typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key & key, M && value)
+  {
+    check_new_key(key);
+    return base::insert_or_assign(key, std::forward<M>(value));
+  }
+
+  T & operator[](const Key & key)
+  {
+    check_new_key(key);
+    return base::operator[](key);
+  }
+
+private:
+  void check(size_t required) const
+  {
+    tlsf_cpp::detail::check_capacity("rt::unordered_map", required, capacity_);
+  }
+
+  void check_new_key(const Key & key) const
+  {
+    if (size() >= capacity_ && base::find(key) == base::end()) {
+      check(size() + 1);
+    }
+  }
+
+  size_t capacity_;
+};
+
+/// Double-ended queue in a ring buffer of fixed capacity.
+/**
+ * The storage for capacity elements is allocated at construction. Pushing into a full deque
+ * throws std::length_error and leaves it unchanged.
+ */
+template<typename T, typename Alloc = tlsf_heap_allocator<T>>
+class deque
+{
+  using traits = std::allocator_traits<Alloc>;
+
+  template<bool Const>
+  class basic_iterator
+  {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+    using container = std::conditional_t<Const, const deque, deque>;
+
+    basic_iterator() = default;
+    basic_iterator(container * parent, size_t index)
+    : parent_(parent), index_(index)
+    {
+    }
+
+    // Iterators convert to const iterators.
+    operator basic_iterator<true>() const
+    {
+      return basic_iterator<true>(parent_, index_);
+    }
+
+    reference operator*() const {return (*parent_)[index_];}
+    pointer operator->() const {return &(*parent_)[index_];}
+    reference operator[](difference_type n) const {return (*parent_)[index_ + n];}
+
+    basic_iterator & operator++() {++index_; return *this;}
+    basic_iterator & operator--() {--index_; return *this;}
+    basic_iterator operator++(int) {auto old = *this; ++index_; return old;}
+    basic_iterator operator--(int) {auto old = *this; --index_; return old;}
+    basic_iterator & operator+=(difference_type n) {index_ += n; return *this;}
+    basic_iterator & operator-=(difference_type n) {index_ -= n; return *this;}
+    basic_iterator operator+(difference_type n) const {return {parent_, index_ + n};}
+    basic_iterator operator-(difference_type n) const {return {parent_, index_ - n};}
+    friend basic_iterator operator+(difference_type n, const basic_iterator & it)
+    {
+      return it + n;
+    }
+    difference_type operator-(const basic_iterator & other) const
+    {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const basic_iterator & other) const {return index_ == other.index_;}
+    bool operator!=(const basic_iterator & other) const {return index_ != other.index_;}
+    bool operator<(const basic_iterator & other) const {return index_ < other.index_;}
+    bool operator>(const basic_iterator & other) const {return index_ > other.index_;}
+    bool operator<=(const basic_iterator & other) const {return index_ <= other.index_;}
+    bool operator>=(const basic_iterator & other) const {return index_ >= other.index_;}
+
+private:
+    container * parent_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  /// Not real time safe.
+  explicit deque(size_t capacity, const Alloc & alloc = Alloc())
+  : alloc_(alloc), data_(traits::allocate(alloc_, capacity)), capacity_(capacity), head_(0),
+    size_(0)
+  {
+  }
+
+  deque(const deque & other)
+  : deque(other.capacity_, other.alloc_)
+  {
+    for (const T & value : other) {
+      push_back(value);
+    }
+  }
+
+  // The moved-from deque is left without capacity.
+  deque(deque && other) noexcept
+  : alloc_(other.alloc_), data_(other.data_), capacity_(other.capacity_), head_(other.head_),
+    size_(other.size_)
+  {
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+
+  deque & operator=(const deque & other)
+  {
+    if (this != &other) {
+      check(other.size_);
+      clear();
+      for (const T & value : other) {
+        push_back(value);
+      }
+    }
+    return *this;
+  }
+
+  ~deque()
+  {
+    clear();
+    if (data_ != nullptr) {
+      traits::deallocate(alloc_, data_, capacity_);
+    }
+  }
+
+  allocator_type get_allocator() const
+  {
+    return alloc_;
+  }
+
+  size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  bool empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  bool full() const noexcept
+  {
+    return size_ == capacity_;
+  }
+
+  T & operator[](size_t index) noexcept
+  {
+    return data_[slot(index)];
+  }
+
+  const T & operator[](size_t index) const noexcept
+  {
+    return data_[slot(index)];
+  }
+
+  T & at(size_t index)
+  {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  const T & at(size_t index) const
+  {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  T & front() noexcept {return (*this)[0];}
+  const T & front() const noexcept {return (*this)[0];}
+  T & back() noexcept {return (*this)[size_ - 1];}
+  const T & back() const noexcept {return (*this)[size_ - 1];}
+
+  iterator begin() noexcept {return iterator(this, 0);}
+  iterator end() noexcept {return iterator(this, size_);}
+  const_iterator begin() const noexcept {return const_iterator(this, 0);}
+  const_iterator end() const noexcept {return const_iterator(this, size_);}
+  const_iterator cbegin() const noexcept {return begin();}
+  const_iterator cend() const noexcept {return end();}
+
+  void push_back(const T & value)
+  {
+    emplace_back(value);
+  }
+
+  void push_back(T && value)
+  {
+    emplace_back(std::move(value));
+  }
+
+  void push_front(const T & value)
+  {
+    emplace_front(value);
+  }
+
+  void push_front(T && value)
+  {
+    emplace_front(std::move(value));
+  }
+
+  template<typename ... Args>
+  T & emplace_back(Args && ... args)
+  {
+    check(size_ + 1);
+    T * element = data_ + slot(size_);
+    traits::construct(alloc_, element, std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+  }
+
+  template<typename ... Args>
+  T & emplace_front(Args && ... args)
+  {
+    check(size_ + 1);
+    size_t new_head = head_ == 0 ? capacity_ - 1 : head_ - 1;
+    traits::construct(alloc_, data_ + new_head, std::forward<Args>(args)...);
+    head_ = new_head;
+    ++size_;
+    return data_[head_];
+  }
+
+  void pop_back() noexcept
+  {
+    traits::destroy(alloc_, &back());
+    --size_;
+  }
+
+  void pop_front() noexcept
+  {
+    traits::destroy(alloc_, &front());
+    head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+    --size_;
+  }
+
+  void clear() noexcept
+  {
+    while (!empty()) {
+      pop_back();
+    }
+    head_ = 0;
+  }
+
+private:
+  size_t slot(size_t index) const noexcept
+  {
+    size_t position = head_ + index;
+    return position >= capacity_ ? position - capacity_ : position;
+  }
+
+  void check(size_t required) const
+  {
+    tlsf_cpp::detail::check_capacity("rt::deque", required, capacity_);
+  }
+
+  void check_index(size_t index) const
+  {
+    if (index >= size_) {
+      throw std::out_of_range("rt::deque: index out of range");
+    }
+  }
+
+  Alloc alloc_;
+  T * data_;
+  size_t capacity_;
+  size_t head_;
+  size_t size_;
+};
+
+}  // namespace rt
+}  // namespace tlsf_cpp
+
+#endif  // TLSF_CPP__TLSF_CONTAINERS_HPP_
@@ -0,0 +1,381 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Debug policies for basic_tlsf_pool, selected at compile time.
+//
+// tlsf_no_debug adds nothing to the pool. tlsf_debug_checks surrounds every block with guard
+// canaries, poisons memory on allocation and on release, checks blocks when they are freed, and
+// keeps a list of live blocks per arena so that the whole pool can be validated on demand or
+// by a tlsf_pool_checker thread.
+//
+// Pools use tlsf_default_debug unless told otherwise, which is tlsf_debug_checks if
+// TLSF_CPP_DEBUG is defined and tlsf_no_debug otherwise. Release builds leave it undefined, so
+// the checks compile out completely.
+
+#ifndef TLSF_CPP__TLSF_DEBUG_POLICY_HPP_
+#define TLSF_CPP__TLSF_DEBUG_POLICY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+/// No debugging: blocks are handed out exactly as TLSF returns them.
+struct tlsf_no_debug
+{
+  static constexpr bool enabled = false;
+
+  struct arena_state
+  {
+  };
+
+  // Where a pool links blocks freed by other threads than its owner: the block itself.
+  static void * remote_link(void * block) noexcept
+  {
+    return block;
+  }
+
+  static void * remote_block(void * link) noexcept
+  {
+    return link;
+  }
+
+  // Unknown without a header; pools only need it for debugging.
+  static size_t block_size(const void *) noexcept
+  {
+    return 0;
+  }
+};
+
+/// A corruption found by tlsf_debug_checks.
+struct tlsf_debug_failure
+{
+  enum kind_type
+  {
+    /// The block was already freed.
+    double_free,
+    /// The header in front of the block was overwritten, or the pointer never came from the pool.
+    header_corrupted,
+    /// The canary behind the block was overwritten.
+    overrun,
+    /// The block was freed with another size than it was allocated with.
+    size_mismatch,
+  };
+
+  kind_type kind;
+  /// The block as returned to the user.
+  const void * block;
+  /// Size recorded at allocation, or passed to the release for double frees and bad headers.
+  size_t size;
+};
+
+/// Canaries, poisoning, double-free detection and live-block tracking.
+/**
+ * Every block carries a header in front of it and a canary behind it, which adds up to 56
+ * bytes plus alignment padding per allocation. Freed blocks are checked before going back to
+ * TLSF; when a check fails, the failure handler is called and the block is leaked rather than
+ * risking the TLSF free lists. Double frees are found as long as TLSF has not reused the block.
+ *
+ * The default failure handler prints the failure and aborts.
+ */
+class tlsf_debug_checks
+{
+public:
+  static constexpr bool enabled = true;
+
+  using failure_handler = void (*)(const tlsf_debug_failure &);
+
+  /// Byte written over newly allocated memory.
+  static constexpr unsigned char allocated_poison = 0xcd;
+  /// Byte written over freed memory.
+  static constexpr unsigned char freed_poison = 0xdd;
+
+  struct block_header
+  {
+    block_header * prev;
+    block_header * next;
+    size_t size;
+    uint64_t magic;
+  };
+
+  /// Live blocks of one arena, guarded by the arena lock.
+  struct arena_state
+  {
+    block_header * live = nullptr;
+    size_t live_count = 0;
+  };
+
+  /// Replace the failure handler; nullptr restores the default.
+  static void set_failure_handler(failure_handler handler) noexcept
+  {
+    handler_slot().store(handler, std::memory_order_release);
+  }
+
+  /// Bytes to allocate from TLSF on top of the requested size.
+  static constexpr size_t overhead(size_t alignment) noexcept
+  {
+    return front_padding(alignment) + sizeof(uint64_t);
+  }
+
+  /// Set up the header and canary of a raw block and return the user block inside it.
+  static void * on_allocate(arena_state & state, void * raw, size_t size, size_t alignment)
+  {
+    char * block = static_cast<char *>(raw) + front_padding(alignment);
+    block_header * header = header_of(block);
+    header->size = size;
+    header->magic = live_magic;
+    header->prev = nullptr;
+    header->next = state.live;
+    if (state.live != nullptr) {
+      state.live->prev = header;
+    }
+    state.live = header;
+    ++state.live_count;
+    memset(block, allocated_poison, size);
+    memcpy(block + size, &canary, sizeof(canary));
+    return block;
+  }
+
+  /// Check a block about to be freed.
+  /// \param from_queue True if the block is taken from the queue of blocks freed by other
+  /// threads, where on_remote_deallocate marked it; a direct free of a queued block is a
+  /// double free.
+  /// \return The raw block to give back to TLSF, or nullptr if the block must be leaked.
+  static void * on_deallocate(
+    arena_state & state, void * ptr, size_t size, size_t alignment, bool from_queue)
+  {
+    char * block = static_cast<char *>(ptr);
+    block_header * header = header_of(block);
+    if (header->magic != (from_queue ? queued_magic : live_magic)) {
+      fail(
+        header->magic == freed_magic || header->magic == queued_magic ?
+        tlsf_debug_failure::double_free : tlsf_debug_failure::header_corrupted, block, size);
+      return nullptr;
+    }
+    if (!check_block(header)) {
+      return nullptr;
+    }
+    if (header->size != size) {
+      fail(tlsf_debug_failure::size_mismatch, block, header->size);
+      return nullptr;
+    }
+    unlink(state, header);
+    header->magic = freed_magic;
+    memset(block, freed_poison, size + sizeof(canary));
+    return block - front_padding(alignment);
+  }
+
+  /// Check a block freed by another thread than the owner of its pool, before it is queued.
+  /// \return False if the block must be leaked.
+  static bool on_remote_deallocate(void * ptr, size_t size)
+  {
+    char * block = static_cast<char *>(ptr);
+    block_header * header = header_of(block);
+    if (header->magic != live_magic) {
+      fail(
+        header->magic == freed_magic || header->magic == queued_magic ?
+        tlsf_debug_failure::double_free : tlsf_debug_failure::header_corrupted, block, size);
+      return false;
+    }
+    if (!check_block(header)) {
+      return false;
+    }
+    if (header->size != size) {
+      fail(tlsf_debug_failure::size_mismatch, block, header->size);
+      return false;
+    }
+    header->magic = queued_magic;
+    return true;
+  }
+
+  /// Two words of a queued block the pool may use to link it: the ones TLSF itself reserves
+  /// at the start of the padding, see front_padding().
+  static void * remote_link(void * block) noexcept
+  {
+    return static_cast<char *>(block) - sizeof(block_header) - 2 * sizeof(void *);
+  }
+
+  static void * remote_block(void * link) noexcept
+  {
+    return static_cast<char *>(link) + 2 * sizeof(void *) + sizeof(block_header);
+  }
+
+  /// Size a live block was allocated with.
+  static size_t block_size(const void * block) noexcept
+  {
+    return (reinterpret_cast<const block_header *>(block) - 1)->size;
+  }
+
+  /// Check every live block of an arena.
+  /// \return The number of corrupted blocks found.
+  static size_t walk(const arena_state & state)
+  {
+    size_t corrupted = 0;
+    size_t visited = 0;
+    for (block_header * header = state.live; header != nullptr && visited < state.live_count;
+      header = header->next, ++visited)
+    {
+      if (header->magic != live_magic && header->magic != queued_magic) {
+        fail(tlsf_debug_failure::header_corrupted, header + 1, header->size);
+        // The links of this header cannot be trusted either.
+        return corrupted + 1;
+      }
+      if (!check_block(header)) {
+        ++corrupted;
+      }
+    }
+    return corrupted;
+  }
+
+private:
+  static constexpr uint64_t live_magic = 0x7f5c0ffee11ab10cULL;
+  static constexpr uint64_t freed_magic = 0x7f5deadf4eeb10cULL;
+  // Freed by another thread than the owner and waiting for the owner to release it.
+  static constexpr uint64_t queued_magic = 0x7f5a11ed0ffb10cULL;
+  static constexpr uint64_t canary = 0xa5c3a5c3a5c3a5c3ULL;
+
+  // TLSF keeps its free-list links in the first two words of a free block; leaving them alone
+  // lets the header survive the release, which is how double frees are recognized.
+  static constexpr size_t front_padding(size_t alignment) noexcept
+  {
+    size_t needed = 2 * sizeof(void *) + sizeof(block_header);
+    size_t unit = alignment > alignof(void *) ? alignment : alignof(void *);
+    return (needed + unit - 1) / unit * unit;
+  }
+
+  static block_header * header_of(char * block) noexcept
+  {
+    return reinterpret_cast<block_header *>(block) - 1;
+  }
+
+  static bool check_block(const block_header * header)
+  {
+    uint64_t tail;
+    const char * block = reinterpret_cast<const char *>(header + 1);
+    memcpy(&tail, block + header->size, sizeof(tail));
+    if (tail != canary) {
+      fail(tlsf_debug_failure::overrun, block, header->size);
+      return false;
+    }
+    return true;
+  }
+
+  static void unlink(arena_state & state, block_header * header) noexcept
+  {
+    if (header->prev != nullptr) {
+      header->prev->next = header->next;
+    } else {
+      state.live = header->next;
+    }
+    if (header->next != nullptr) {
+      header->next->prev = header->prev;
+    }
+    --state.live_count;
+  }
+
+  static void fail(tlsf_debug_failure::kind_type kind, const void * block, size_t size)
+  {
+    tlsf_debug_failure failure{kind, block, size};
+    failure_handler handler = handler_slot().load(std::memory_order_acquire);
+    if (handler != nullptr) {
+      handler(failure);
+      return;
+    }
+    static const char * names[] = {"double free", "corrupted header", "overrun", "size mismatch"};
+    fprintf(stderr, "tlsf_cpp: %s of block %p (%zu bytes)\n", names[kind], block, size);
+    abort();
+  }
+
+  static std::atomic<failure_handler> & handler_slot() noexcept
+  {
+    static std::atomic<failure_handler> handler{nullptr};
+    return handler;
+  }
+};
+
+#ifdef TLSF_CPP_DEBUG
+using tlsf_default_debug = tlsf_debug_checks;
+#else
+using tlsf_default_debug = tlsf_no_debug;
+#endif
+
+/// Validate a pool periodically from a background thread.
+/**
+ * Calls check_consistency() on the pool every period until destroyed. The walk holds each
+ * arena lock while it runs, so the pool needs a lock policy other than tlsf_no_lock, and
+ * real-time threads allocating from it may be delayed by the length of a walk.
+ * Does nothing useful for pools without tlsf_debug_checks.
+ */
+template<typename PoolT>
+class tlsf_pool_checker
+{
+public:
+  tlsf_pool_checker(PoolT & pool, std::chrono::milliseconds period)
+  : pool_(pool), period_(period), thread_([this]() {run();})
+  {
+  }
+
+  tlsf_pool_checker(const tlsf_pool_checker &) = delete;
+  tlsf_pool_checker & operator=(const tlsf_pool_checker &) = delete;
+
+  ~tlsf_pool_checker()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+  }
+
+  /// Number of walks completed so far.
+  uint64_t walks() const noexcept
+  {
+    return walks_.load(std::memory_order_relaxed);
+  }
+
+  /// Number of corrupted blocks found over all walks.
+  uint64_t corrupted_blocks() const noexcept
+  {
+    return corrupted_blocks_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    while (!wakeup_.wait_for(guard, period_, [this]() {return stop_;})) {
+      corrupted_blocks_.fetch_add(pool_.check_consistency(), std::memory_order_relaxed);
+      walks_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  PoolT & pool_;
+  std::chrono::milliseconds period_;
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  bool stop_ = false;
+  std::atomic<uint64_t> walks_{0};
+  std::atomic<uint64_t> corrupted_blocks_{0};
+  // Started last, once everything it uses is initialized.
+  std::thread thread_;
+};
+
+#endif  // TLSF_CPP__TLSF_DEBUG_POLICY_HPP_
@@ -0,0 +1,243 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Synchronization policies for TLSF pools shared between threads.
+//
+// A lock policy is a type with lock(), try_lock() and unlock(). basic_tlsf_pool keeps one
+// instance per arena and holds it around every call into TLSF.
+
+#ifndef TLSF_CPP__TLSF_LOCK_POLICY_HPP_
+#define TLSF_CPP__TLSF_LOCK_POLICY_HPP_
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+/// No synchronization: the pool must only ever be used from one thread at a time.
+struct tlsf_no_lock
+{
+  void lock() noexcept {}
+  bool try_lock() noexcept {return true;}
+  void unlock() noexcept {}
+};
+
+/// A pthread mutex using the priority inheritance protocol, so that a low priority thread
+/// holding the pool lock is boosted while a real-time thread waits for it.
+class tlsf_pi_mutex
+{
+public:
+  tlsf_pi_mutex()
+  {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    int result = pthread_mutex_init(&mutex_, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (result != 0) {
+      throw std::runtime_error("tlsf_pi_mutex: pthread_mutex_init failed");
+    }
+  }
+
+  tlsf_pi_mutex(const tlsf_pi_mutex &) = delete;
+  tlsf_pi_mutex & operator=(const tlsf_pi_mutex &) = delete;
+
+  ~tlsf_pi_mutex()
+  {
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  void lock() noexcept
+  {
+    pthread_mutex_lock(&mutex_);
+  }
+
+  bool try_lock() noexcept
+  {
+    return pthread_mutex_trylock(&mutex_) == 0;
+  }
+
+  void unlock() noexcept
+  {
+    pthread_mutex_unlock(&mutex_);
+  }
+
+private:
+  pthread_mutex_t mutex_;
+};
+
+/// A process-shared, robust pthread mutex using priority inheritance, for pools placed in
+/// shared memory such as basic_tlsf_shm_pool.
+/**
+ * If a process dies while holding the lock, the next process to lock it takes it over instead
+ * of waiting forever and counts the death in owner_deaths(). The TLSF operation the dead
+ * process was in the middle of may have left its arena inconsistent.
+ * Must live in the shared memory itself and be constructed there exactly once.
+ */
+class tlsf_robust_pi_mutex
+{
+public:
+  tlsf_robust_pi_mutex()
+  {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int result = pthread_mutex_init(&mutex_, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (result != 0) {
+      throw std::runtime_error("tlsf_robust_pi_mutex: pthread_mutex_init failed");
+    }
+  }
+
+  tlsf_robust_pi_mutex(const tlsf_robust_pi_mutex &) = delete;
+  tlsf_robust_pi_mutex & operator=(const tlsf_robust_pi_mutex &) = delete;
+
+  ~tlsf_robust_pi_mutex()
+  {
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  void lock() noexcept
+  {
+    recover(pthread_mutex_lock(&mutex_));
+  }
+
+  bool try_lock() noexcept
+  {
+    int result = pthread_mutex_trylock(&mutex_);
+    recover(result);
+    return result == 0 || result == EOWNERDEAD;
+  }
+
+  void unlock() noexcept
+  {
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  /// Number of times the lock was taken over from a process that died holding it.
+  uint64_t owner_deaths() const noexcept
+  {
+    return owner_deaths_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void recover(int result) noexcept
+  {
+    if (result == EOWNERDEAD) {
+      pthread_mutex_consistent(&mutex_);
+      owner_deaths_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  pthread_mutex_t mutex_;
+  std::atomic<uint64_t> owner_deaths_{0};
+};
+
+/// A FIFO ticket spinlock.
+/**
+ * Waiters are served in arrival order and never sleep. Only suitable when the threads sharing
+ * the pool run on different cores: a SCHED_FIFO waiter spinning on the core of a lower
+ * priority lock holder never lets it run, even though it yields periodically.
+ */
+class tlsf_ticket_spinlock
+{
+public:
+  tlsf_ticket_spinlock() = default;
+  tlsf_ticket_spinlock(const tlsf_ticket_spinlock &) = delete;
+  tlsf_ticket_spinlock & operator=(const tlsf_ticket_spinlock &) = delete;
+
+  void lock() noexcept
+  {
+    uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    for (uint32_t spins = 1; serving_.load(std::memory_order_acquire) != ticket; ++spins) {
+      // Give a preempted holder on the same core a chance to run now and then.
+      if (spins % 1024 == 0) {
+        sched_yield();
+      }
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#elif defined(__aarch64__)
+      asm volatile ("yield");
+#endif
+    }
+  }
+
+  bool try_lock() noexcept
+  {
+    uint32_t ticket = serving_.load(std::memory_order_relaxed);
+    return next_.compare_exchange_strong(
+      ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock() noexcept
+  {
+    serving_.fetch_add(1, std::memory_order_release);
+  }
+
+private:
+  std::atomic<uint32_t> next_{0};
+  std::atomic<uint32_t> serving_{0};
+};
+
+/// Split the pool into ArenaCount independent TLSF arenas.
+/**
+ * Each thread allocates from its own arena, assigned round-robin on first use, and only
+ * spills into the other arenas when its own is exhausted. Every arena is still guarded by an
+ * ArenaLock, which is only contended when a block is freed by a thread other than the one that
+ * allocated it or when more threads than arenas share the pool.
+ */
+template<size_t ArenaCount = 8, typename ArenaLock = tlsf_pi_mutex>
+class tlsf_per_thread_pools : public ArenaLock
+{
+public:
+  static_assert(ArenaCount > 0, "tlsf_per_thread_pools needs at least one arena");
+  static constexpr size_t arena_count = ArenaCount;
+};
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+template<typename LockPolicy, typename = void>
+struct arena_count
+{
+  static constexpr size_t value = 1;
+};
+
+template<typename LockPolicy>
+struct arena_count<LockPolicy, std::void_t<decltype(LockPolicy::arena_count)>>
+{
+  static constexpr size_t value = LockPolicy::arena_count;
+};
+
+// Process-wide index of the calling thread, assigned in order of first use.
+inline size_t thread_slot()
+{
+  static std::atomic<size_t> next_slot{0};
+  thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+  return slot;
+}
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+#endif  // TLSF_CPP__TLSF_LOCK_POLICY_HPP_
@@ -0,0 +1,97 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std::pmr::memory_resource over a TLSF pool, so that std::pmr containers can allocate from
+// the same pool as tlsf_heap_allocator without being templated on it.
+
+#ifndef TLSF_CPP__TLSF_MEMORY_RESOURCE_HPP_
+#define TLSF_CPP__TLSF_MEMORY_RESOURCE_HPP_
+
+#include <memory_resource>
+#include <new>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+template<typename LockPolicy = tlsf_no_lock>
+class basic_tlsf_memory_resource : public std::pmr::memory_resource
+{
+public:
+  using pool_type = basic_tlsf_pool<LockPolicy>;
+
+  /// Create a resource owning a new pool of the given size.
+  explicit basic_tlsf_memory_resource(size_t pool_size = 1024 * 1024)
+  : pool_(pool_type::create(pool_size))
+  {
+  }
+
+  /// Create a resource allocating from an existing pool.
+  explicit basic_tlsf_memory_resource(pool_type & pool)
+  : pool_(&pool)
+  {
+    pool_->retain();
+  }
+
+  /// Create a resource allocating from the pool of an existing allocator.
+  template<typename T, size_t DefaultPoolSize>
+  explicit basic_tlsf_memory_resource(
+    const tlsf_heap_allocator<T, DefaultPoolSize, LockPolicy> & alloc)
+  : basic_tlsf_memory_resource(*alloc.pool)
+  {
+  }
+
+  basic_tlsf_memory_resource(const basic_tlsf_memory_resource &) = delete;
+  basic_tlsf_memory_resource & operator=(const basic_tlsf_memory_resource &) = delete;
+
+  ~basic_tlsf_memory_resource() override
+  {
+    pool_->release();
+  }
+
+  pool_type & pool() const noexcept
+  {
+    return *pool_;
+  }
+
+protected:
+  void * do_allocate(size_t bytes, size_t alignment) override
+  {
+    void * ptr = pool_->allocate(bytes, alignment);
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  void do_deallocate(void * ptr, size_t bytes, size_t alignment) override
+  {
+    pool_->deallocate(ptr, bytes, alignment);
+  }
+
+  // Two resources are interchangeable if and only if they allocate from the same pool.
+  bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+  {
+    auto tlsf_other = dynamic_cast<const basic_tlsf_memory_resource *>(&other);
+    return tlsf_other != nullptr && tlsf_other->pool_ == pool_;
+  }
+
+private:
+  pool_type * pool_;
+};
+
+/// Memory resource over an unsynchronized pool.
+using tlsf_memory_resource = basic_tlsf_memory_resource<>;
+
+#endif  // TLSF_CPP__TLSF_MEMORY_RESOURCE_HPP_
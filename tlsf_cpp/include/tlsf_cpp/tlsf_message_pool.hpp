@@ -0,0 +1,163 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A pool of preallocated messages of one type, loaned out as the unique_ptr rclcpp publishers
+// accept and recycled by its deleter once the last subscriber lets go of them.
+
+#ifndef TLSF_CPP__TLSF_MESSAGE_POOL_HPP_
+#define TLSF_CPP__TLSF_MESSAGE_POOL_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "rclcpp/allocator/allocator_deleter.hpp"
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_object_pool.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+/// Preallocated messages for zero-copy intra-process publishing.
+/**
+ * The pool carves message_count message slots out of a TLSF pool. Create the publisher and the
+ * subscriptions of the topic with get_allocator(), publish messages obtained from loan(), and
+ * take them as unique_ptr in the subscription callbacks: with intra-process communication the
+ * message then travels from publisher to subscriber without being copied, and its deleter puts
+ * the slot back into the pool. Once warmed up, publishing makes no allocator call at all.
+ *
+ * Copies rclcpp makes for shared_ptr or additional subscriptions also come from the slots while
+ * some are free, and from the rest of the TLSF pool otherwise.
+ * Only the message itself is pooled: dynamically sized fields still use the allocator of the
+ * message type.
+ *
+ * The default lock policy lets the publisher and the executor run in different threads.
+ * The message pool must outlive the publisher, the subscriptions and every loaned message.
+ */
+template<typename MessageT, typename LockPolicy = tlsf_pi_mutex>
+class tlsf_message_pool
+{
+public:
+  using pool_type = basic_tlsf_pool<LockPolicy>;
+  using slab_type = basic_tlsf_object_slab<LockPolicy>;
+  /// Allocator to create the publisher and subscriptions with.
+  using allocator_type =
+    tlsf_object_pool_allocator<void, MessageT, 64, 1024 * 1024, LockPolicy>;
+  using message_allocator_type =
+    typename std::allocator_traits<allocator_type>::template rebind_alloc<MessageT>;
+  using deleter_type = rclcpp::allocator::Deleter<message_allocator_type, MessageT>;
+  using unique_ptr = std::unique_ptr<MessageT, deleter_type>;
+
+  /// Create a TLSF pool holding message_count messages plus fallback_pool_size bytes for the
+  /// other allocations made through get_allocator(). Not real time safe.
+  explicit tlsf_message_pool(size_t message_count, size_t fallback_pool_size = 1024 * 1024)
+  : tlsf_message_pool(
+      *pool_type::create(slab_bytes(message_count) + fallback_pool_size), message_count, true)
+  {
+  }
+
+  /// Carve the messages out of an existing pool. Not real time safe.
+  tlsf_message_pool(pool_type & pool, size_t message_count)
+  : tlsf_message_pool(pool, message_count, false)
+  {
+  }
+
+  tlsf_message_pool(const tlsf_message_pool &) = delete;
+  tlsf_message_pool & operator=(const tlsf_message_pool &) = delete;
+
+  /// Take a default-constructed message out of the pool.
+  /**
+   * Real time safe as long as the message constructor is.
+   * \return The message, or an empty pointer if every message is on loan.
+   */
+  unique_ptr loan()
+  {
+    void * slot = allocator_->slab->allocate();
+    if (slot == nullptr) {
+      return unique_ptr(nullptr, deleter_);
+    }
+    MessageT * message;
+    try {
+      message = new (slot) MessageT();
+    } catch (...) {
+      allocator_->slab->deallocate(slot);
+      throw;
+    }
+    return unique_ptr(message, deleter_);
+  }
+
+  /// Allocator to pass to PublisherOptionsWithAllocator and SubscriptionOptionsWithAllocator.
+  std::shared_ptr<allocator_type> get_allocator() const noexcept
+  {
+    return allocator_;
+  }
+
+  /// Number of messages not currently on loan.
+  size_t available() const noexcept
+  {
+    return allocator_->slab->available();
+  }
+
+  size_t capacity() const noexcept
+  {
+    return allocator_->slab->slot_count();
+  }
+
+  pool_type & pool() const noexcept
+  {
+    return *allocator_->pool;
+  }
+
+private:
+  tlsf_message_pool(pool_type & pool, size_t message_count, bool owns_pool)
+  {
+    slab_type * slab;
+    try {
+      slab = slab_type::create(pool, sizeof(MessageT), alignof(MessageT), message_count);
+    } catch (...) {
+      if (owns_pool) {
+        pool.release();
+      }
+      throw;
+    }
+    // The allocator takes its own references to the slab and the pool.
+    try {
+      allocator_ = std::make_shared<allocator_type>(*slab);
+    } catch (...) {
+      slab->release();
+      if (owns_pool) {
+        pool.release();
+      }
+      throw;
+    }
+    slab->release();
+    if (owns_pool) {
+      pool.release();
+    }
+    message_allocator_ = std::make_unique<message_allocator_type>(*allocator_);
+    rclcpp::allocator::set_allocator_for_deleter(&deleter_, message_allocator_.get());
+  }
+
+  // Room for the slab and its alignment slack; the TLSF overhead is covered by the fallback.
+  static size_t slab_bytes(size_t message_count)
+  {
+    return message_count * (sizeof(MessageT) + alignof(MessageT)) + alignof(MessageT);
+  }
+
+  std::shared_ptr<allocator_type> allocator_;
+  // The deleter of every loaned message points to this allocator.
+  std::unique_ptr<message_allocator_type> message_allocator_;
+  deleter_type deleter_;
+};
+
+#endif  // TLSF_CPP__TLSF_MESSAGE_POOL_HPP_
@@ -0,0 +1,89 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Detection of heap calls in sections that must not allocate, such as the steady-state loop of
+// a real-time thread.
+//
+// The guard is implemented by the tlsf_cpp_no_alloc_guard library, which replaces malloc,
+// free and friends with thin wrappers around the glibc allocator that check the guard of the
+// calling thread. The global operator new and delete of libstdc++ are built on malloc and free,
+// so they are caught as well; TLSF pools never call malloc, so their allocations are not. The
+// library replaces the same functions as tlsf_cpp_global; link against one of them only.
+//
+// Defining TLSF_CPP_DISABLE_NO_ALLOC_GUARD compiles the guard out: it does nothing, counts
+// nothing and needs no library.
+
+#ifndef TLSF_CPP__TLSF_NO_ALLOC_GUARD_HPP_
+#define TLSF_CPP__TLSF_NO_ALLOC_GUARD_HPP_
+
+#include <cstdint>
+
+/// Watches the heap calls of the current thread for as long as it lives.
+/**
+ * Guards nest; the action of the innermost one applies, and every guard counts the calls made
+ * within its own lifetime, including those of the guards inside it.
+ *
+ * \code
+ * tlsf_no_alloc_guard guard;
+ * run_steady_state_iteration();
+ * EXPECT_EQ(0u, guard.allocations());
+ * \endcode
+ */
+class tlsf_no_alloc_guard
+{
+public:
+  /// What to do on each heap call inside the guard, besides counting it.
+  enum action_type
+  {
+    count_calls,
+    /// Print the call to stderr, without allocating.
+    log_calls,
+    /// Print the call and abort the process, e.g. to get a core dump pointing at the caller.
+    abort_on_call,
+  };
+
+#ifndef TLSF_CPP_DISABLE_NO_ALLOC_GUARD
+  explicit tlsf_no_alloc_guard(action_type action = count_calls) noexcept;
+  ~tlsf_no_alloc_guard();
+
+  /// Allocations, including reallocations, made by this thread since the guard was created.
+  uint64_t allocations() const noexcept;
+  /// Frees of non-null pointers made by this thread since the guard was created.
+  uint64_t deallocations() const noexcept;
+
+private:
+  bool previous_active_;
+  action_type previous_action_;
+  uint64_t allocations_at_start_;
+  uint64_t deallocations_at_start_;
+#else
+  explicit tlsf_no_alloc_guard(action_type = count_calls) noexcept {}
+
+  uint64_t allocations() const noexcept
+  {
+    return 0;
+  }
+
+  uint64_t deallocations() const noexcept
+  {
+    return 0;
+  }
+#endif
+
+public:
+  tlsf_no_alloc_guard(const tlsf_no_alloc_guard &) = delete;
+  tlsf_no_alloc_guard & operator=(const tlsf_no_alloc_guard &) = delete;
+};
+
+#endif  // TLSF_CPP__TLSF_NO_ALLOC_GUARD_HPP_
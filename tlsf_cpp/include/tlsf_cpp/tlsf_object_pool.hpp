@@ -0,0 +1,348 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Fixed-size object pool allocator: single objects of one hot type come from a preallocated
+// slab in constant time, everything else falls back to the TLSF pool.
+
+#ifndef TLSF_CPP__TLSF_OBJECT_POOL_HPP_
+#define TLSF_CPP__TLSF_OBJECT_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+/// A slab of equally sized slots carved out of a TLSF pool.
+/**
+ * Free slots are linked through their first bytes, so allocate() and deallocate() are a
+ * single pointer swap and never touch the TLSF pool. The free list is guarded by the same
+ * LockPolicy as the pool; with tlsf_no_lock the slab is not synchronized.
+ * Like tlsf_pool, slabs made with create() are reference counted and release their memory
+ * back to the pool with the last reference.
+ */
+template<typename LockPolicy = tlsf_no_lock>
+class basic_tlsf_object_slab
+{
+public:
+  using pool_type = basic_tlsf_pool<LockPolicy>;
+
+  /// Carve slot_count slots of slot_size bytes out of the given pool.
+  /**
+   * Not real time safe.
+   * \throws std::bad_alloc if the pool cannot hold the slab.
+   */
+  basic_tlsf_object_slab(
+    pool_type & pool, size_t slot_size, size_t slot_alignment, size_t slot_count)
+  : pool_(&pool),
+    slot_size_(round_up(std::max(slot_size, sizeof(free_slot)), std::max(
+        slot_alignment, alignof(free_slot)))),
+    slot_alignment_(std::max(slot_alignment, alignof(free_slot))),
+    slot_count_(slot_count),
+    available_(slot_count),
+    refcount_(0),
+    managed_(false)
+  {
+    if (slot_count_ > std::numeric_limits<size_t>::max() / slot_size_) {
+      throw std::bad_array_new_length();
+    }
+    slab_ = static_cast<char *>(pool_->allocate(slot_size_ * slot_count_, slot_alignment_));
+    if (slab_ == nullptr && slot_count_ > 0) {
+      throw std::bad_alloc();
+    }
+    pool_->retain();
+    free_list_ = nullptr;
+    for (size_t i = slot_count_; i > 0; --i) {
+      auto slot = reinterpret_cast<free_slot *>(slab_ + (i - 1) * slot_size_);
+      slot->next = free_list_;
+      free_list_ = slot;
+    }
+  }
+
+  basic_tlsf_object_slab(const basic_tlsf_object_slab &) = delete;
+  basic_tlsf_object_slab & operator=(const basic_tlsf_object_slab &) = delete;
+
+  ~basic_tlsf_object_slab()
+  {
+    pool_->deallocate(slab_, slot_size_ * slot_count_, slot_alignment_);
+    pool_->release();
+  }
+
+  /// Create a reference counted slab; the caller holds the first reference.
+  static basic_tlsf_object_slab * create(
+    pool_type & pool, size_t slot_size, size_t slot_alignment, size_t slot_count)
+  {
+    auto slab = new basic_tlsf_object_slab(pool, slot_size, slot_alignment, slot_count);
+    slab->managed_ = true;
+    slab->refcount_.store(1, std::memory_order_relaxed);
+    return slab;
+  }
+
+  void retain() noexcept
+  {
+    if (managed_) {
+      refcount_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void release() noexcept
+  {
+    if (managed_ && refcount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  /// Take a slot from the slab.
+  /// \return The slot, or nullptr if all slots are in use.
+  void * allocate() noexcept
+  {
+    lock_.lock();
+    free_slot * slot = free_list_;
+    if (slot != nullptr) {
+      free_list_ = slot->next;
+      --available_;
+    }
+    lock_.unlock();
+    return slot;
+  }
+
+  /// Return a slot obtained from allocate().
+  void deallocate(void * ptr) noexcept
+  {
+    auto slot = static_cast<free_slot *>(ptr);
+    lock_.lock();
+    slot->next = free_list_;
+    free_list_ = slot;
+    ++available_;
+    lock_.unlock();
+  }
+
+  /// Whether ptr is one of the slots of this slab.
+  bool contains(const void * ptr) const noexcept
+  {
+    auto p = static_cast<const char *>(ptr);
+    return p >= slab_ && p < slab_ + slot_size_ * slot_count_;
+  }
+
+  size_t slot_size() const noexcept
+  {
+    return slot_size_;
+  }
+
+  size_t slot_alignment() const noexcept
+  {
+    return slot_alignment_;
+  }
+
+  size_t slot_count() const noexcept
+  {
+    return slot_count_;
+  }
+
+  /// Number of slots currently free.
+  size_t available() const noexcept
+  {
+    return available_;
+  }
+
+  pool_type & pool() const noexcept
+  {
+    return *pool_;
+  }
+
+private:
+  struct free_slot
+  {
+    free_slot * next;
+  };
+
+  static constexpr size_t round_up(size_t value, size_t alignment)
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  pool_type * pool_;
+  char * slab_;
+  free_slot * free_list_;
+  size_t slot_size_;
+  size_t slot_alignment_;
+  size_t slot_count_;
+  size_t available_;
+  std::atomic<size_t> refcount_;
+  bool managed_;
+  LockPolicy lock_;
+};
+
+/// An unsynchronized slab.
+using tlsf_object_slab = basic_tlsf_object_slab<>;
+
+/// Allocator serving single objects of type SlabT from a slab of SlabCount slots.
+/**
+ * Requests for one object with the size of SlabT, whatever the allocator is rebound to, are
+ * served from the slab while it has free slots. Arrays, other sizes and requests made while
+ * the slab is exhausted fall back to the TLSF pool.
+ * All rebound copies share the slab and the pool, so the allocator can be handed to rclcpp
+ * in the same places as tlsf_heap_allocator, e.g. AllocatorMemoryStrategy.
+ * LockPolicy synchronizes both the slab and the pool, see tlsf_lock_policy.hpp.
+ */
+template<typename T, typename SlabT, size_t SlabCount = 64,
+  size_t DefaultPoolSize = 1024 * 1024, typename LockPolicy = tlsf_no_lock>
+struct tlsf_object_pool_allocator
+{
+  // Needed for std::allocator_traits
+  using value_type = T;
+
+  using pool_type = basic_tlsf_pool<LockPolicy>;
+  using slab_type = basic_tlsf_object_slab<LockPolicy>;
+
+  // Needed for std::allocator_traits
+  tlsf_object_pool_allocator()
+  : tlsf_object_pool_allocator(DefaultPoolSize)
+  {
+  }
+
+  /// Create a new pool of the given size holding the slab.
+  explicit tlsf_object_pool_allocator(size_t pool_size)
+  : pool(pool_type::create(pool_size)), slab(nullptr)
+  {
+    try {
+      slab = slab_type::create(*pool, sizeof(SlabT), alignof(SlabT), SlabCount);
+    } catch (...) {
+      pool->release();
+      throw;
+    }
+  }
+
+  /// Carve the slab out of an existing pool.
+  explicit tlsf_object_pool_allocator(pool_type & existing_pool)
+  : pool(&existing_pool),
+    slab(slab_type::create(existing_pool, sizeof(SlabT), alignof(SlabT), SlabCount))
+  {
+    pool->retain();
+  }
+
+  /// Serve objects from an existing slab, whose slots must fit SlabT.
+  explicit tlsf_object_pool_allocator(slab_type & existing_slab)
+  : pool(&existing_slab.pool()), slab(&existing_slab)
+  {
+    if (existing_slab.slot_size() < sizeof(SlabT) ||
+      existing_slab.slot_alignment() < alignof(SlabT))
+    {
+      throw std::invalid_argument("tlsf_object_pool_allocator: slab slots are too small");
+    }
+    pool->retain();
+    slab->retain();
+  }
+
+  tlsf_object_pool_allocator(const tlsf_object_pool_allocator & alloc)
+  : pool(alloc.pool), slab(alloc.slab)
+  {
+    pool->retain();
+    slab->retain();
+  }
+
+  // Needed for std::allocator_traits
+  template<typename U>
+  tlsf_object_pool_allocator(
+    const tlsf_object_pool_allocator<U, SlabT, SlabCount, DefaultPoolSize, LockPolicy> & alloc)
+  : pool(alloc.pool), slab(alloc.slab)
+  {
+    pool->retain();
+    slab->retain();
+  }
+
+  tlsf_object_pool_allocator & operator=(const tlsf_object_pool_allocator & alloc)
+  {
+    alloc.pool->retain();
+    alloc.slab->retain();
+    slab->release();
+    pool->release();
+    pool = alloc.pool;
+    slab = alloc.slab;
+    return *this;
+  }
+
+  ~tlsf_object_pool_allocator()
+  {
+    slab->release();
+    pool->release();
+  }
+
+  // Needed for std::allocator_traits
+  T * allocate(size_t size)
+  {
+    if (size == 1 && uses_slab()) {
+      void * slot = slab->allocate();
+      if (slot != nullptr) {
+        return static_cast<T *>(slot);
+      }
+    }
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    T * ptr = static_cast<T *>(pool->allocate(size * sizeof(T), alignof(T)));
+    if (ptr == nullptr && size > 0) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  // Needed for std::allocator_traits
+  void deallocate(T * ptr, size_t size)
+  {
+    if (uses_slab() && slab->contains(ptr)) {
+      slab->deallocate(ptr);
+      return;
+    }
+    pool->deallocate(ptr, size * sizeof(T), alignof(T));
+  }
+
+  template<typename U>
+  struct rebind
+  {
+    typedef tlsf_object_pool_allocator<U, SlabT, SlabCount, DefaultPoolSize, LockPolicy> other;
+  };
+
+  static constexpr bool uses_slab()
+  {
+    return sizeof(T) == sizeof(SlabT) && alignof(T) <= alignof(SlabT);
+  }
+
+  pool_type * pool;
+  slab_type * slab;
+};
+
+// Needed for std::allocator_traits
+template<typename T, typename U, typename SlabT, size_t N, size_t S, typename L>
+bool operator==(
+  const tlsf_object_pool_allocator<T, SlabT, N, S, L> & a,
+  const tlsf_object_pool_allocator<U, SlabT, N, S, L> & b) noexcept
+{
+  return a.slab == b.slab;
+}
+
+// Needed for std::allocator_traits
+template<typename T, typename U, typename SlabT, size_t N, size_t S, typename L>
+bool operator!=(
+  const tlsf_object_pool_allocator<T, SlabT, N, S, L> & a,
+  const tlsf_object_pool_allocator<U, SlabT, N, S, L> & b) noexcept
+{
+  return a.slab != b.slab;
+}
+
+#endif  // TLSF_CPP__TLSF_OBJECT_POOL_HPP_
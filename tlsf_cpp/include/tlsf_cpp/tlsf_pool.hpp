@@ -0,0 +1,1205 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A single TLSF memory pool that can be shared by allocators and memory resources.
+
+#ifndef TLSF_CPP__TLSF_POOL_HPP_
+#define TLSF_CPP__TLSF_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "tlsf/tlsf.h"
+#include "tlsf_cpp/tlsf_debug_policy.hpp"
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool_stats.hpp"
+#include "tlsf_cpp/tlsf_trace.hpp"
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+// Alignment of the blocks handed out by TLSF itself. Requests for anything stricter go through
+// aligned_malloc, which over-allocates and stores the original block address in front of the
+// returned pointer.
+constexpr size_t natural_alignment = alignof(void *);
+
+constexpr bool is_power_of_two(size_t value)
+{
+  return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Allocate size bytes aligned to alignment from the given pool.
+// The waste is bounded by alignment bytes per block.
+inline void * aligned_malloc(size_t size, size_t alignment, void * pool)
+{
+  if (alignment <= natural_alignment) {
+    return malloc_ex(size, pool);
+  }
+  if (size > std::numeric_limits<size_t>::max() - alignment) {
+    return nullptr;
+  }
+  void * raw = malloc_ex(size + alignment, pool);
+  if (raw == nullptr) {
+    return nullptr;
+  }
+  // Since raw is at least naturally aligned, the gap between raw and the aligned address is
+  // never smaller than natural_alignment, which leaves room for the back pointer.
+  uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + alignment) & ~(alignment - 1);
+  reinterpret_cast<void **>(aligned)[-1] = raw;
+  return reinterpret_cast<void *>(aligned);
+}
+
+// Release a block obtained from aligned_malloc with the same alignment.
+inline void aligned_free(void * ptr, size_t alignment, void * pool)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  if (alignment <= natural_alignment) {
+    free_ex(ptr, pool);
+    return;
+  }
+  free_ex(static_cast<void **>(ptr)[-1], pool);
+}
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+/// A TLSF pool over a contiguous memory area.
+/**
+ * Pools created with create() own their memory and are reference counted: every allocator or
+ * memory resource sharing the pool holds a reference, and the last one to let go destroys it.
+ * Pools declared directly by the user are never deleted through the reference count; the user
+ * must keep them alive for as long as anything allocates from them.
+ *
+ * LockPolicy decides how the pool is shared between threads, see tlsf_lock_policy.hpp.
+ * The default, tlsf_no_lock, is only safe if a single thread uses the pool at a time.
+ *
+ * The pool keeps lock-free usage counters that can be read from any thread with stats().
+ * Fragmentation is only measured on request by inspect(), which is not real time safe.
+ *
+ * DebugPolicy adds overrun and double-free checks to every block, see tlsf_debug_policy.hpp.
+ *
+ * A pool can have an owner thread, see set_owner_thread(). Other threads then never touch the
+ * TLSF structures when they deallocate: they push the block onto a lock-free queue, which the
+ * owner drains a few blocks at a time while it allocates.
+ *
+ * When several components share a pool, each can be charged as a client, see charge_client(),
+ * to find out how much of the pool it uses and to cap it with a quota.
+ */
+template<typename LockPolicy = tlsf_no_lock, typename DebugPolicy = tlsf_default_debug>
+class basic_tlsf_pool
+{
+public:
+  using lock_policy = LockPolicy;
+  using debug_policy = DebugPolicy;
+
+  /// Number of independent TLSF arenas the memory area is split into.
+  static constexpr size_t arena_count = tlsf_cpp::detail::arena_count<LockPolicy>::value;
+
+  /// Create a pool owning a freshly allocated memory area of the given size.
+  /**
+   * Not real time safe.
+   */
+  explicit basic_tlsf_pool(size_t size)
+  : memory_pool_(new char[size]), pool_size_(size), refcount_(0), managed_(false),
+    owns_memory_(true)
+  {
+    memset(memory_pool_, 0, pool_size_);
+    initialize_arenas();
+  }
+
+  /// Create a pool over a memory area owned by the caller, which must outlive the pool.
+  /**
+   * The area may be a static array, a region placed in a dedicated linker section or memory
+   * mapped beforehand; the pool itself never touches the heap. The area is cleared, so that its
+   * pages are faulted in now rather than by the first allocations. Not real time safe.
+   * \throws std::invalid_argument if memory is null or not aligned to std::max_align_t.
+   */
+  basic_tlsf_pool(void * memory, size_t size)
+  : memory_pool_(static_cast<char *>(memory)), pool_size_(size), refcount_(0), managed_(false),
+    owns_memory_(false)
+  {
+    if (memory == nullptr ||
+      reinterpret_cast<uintptr_t>(memory) % alignof(std::max_align_t) != 0)
+    {
+      throw std::invalid_argument("basic_tlsf_pool: memory must be aligned to max_align_t");
+    }
+    memset(memory_pool_, 0, pool_size_);
+    initialize_arenas();
+  }
+
+  basic_tlsf_pool(const basic_tlsf_pool &) = delete;
+  basic_tlsf_pool & operator=(const basic_tlsf_pool &) = delete;
+
+  ~basic_tlsf_pool()
+  {
+    for (auto & arena : arenas_) {
+      destroy_memory_pool(arena.memory);
+    }
+    if (owns_memory_) {
+      delete[] memory_pool_;
+    }
+  }
+
+  /// Create a reference counted pool; the caller holds the first reference.
+  static basic_tlsf_pool * create(size_t size)
+  {
+    auto pool = new basic_tlsf_pool(size);
+    pool->managed_ = true;
+    pool->refcount_.store(1, std::memory_order_relaxed);
+    return pool;
+  }
+
+  /// Take a reference to the pool. Has no effect on pools not created with create().
+  void retain() noexcept
+  {
+    if (managed_) {
+      refcount_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Drop a reference to the pool, destroying it if it was the last one.
+  void release() noexcept
+  {
+    if (managed_ && refcount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  /// Allocate bytes from the pool, aligned to alignment (a power of two).
+  /// \return The block, or nullptr if the pool is exhausted.
+  void * allocate(size_t bytes, size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    void * ptr;
+    if (!timing_enabled()) {
+      ptr = allocate_and_count(bytes, alignment);
+    } else {
+      auto start = std::chrono::steady_clock::now();
+      ptr = allocate_and_count(bytes, alignment);
+      allocate_latency_.record(elapsed_ns(start));
+    }
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      recorder->record(
+        ptr != nullptr ? tlsf_trace_event::allocate : tlsf_trace_event::failed_allocate,
+        ptr, bytes, alignment);
+    }
+    return ptr;
+  }
+
+  /// Return a block to the pool.
+  /// The size and alignment must match the ones used to allocate it.
+  void deallocate(
+    void * ptr, size_t bytes, size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    // Recorded before the block is freed, so that an allocation reusing it on another thread
+    // always appears later in the trace.
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      if (ptr != nullptr) {
+        recorder->record(tlsf_trace_event::deallocate, ptr, bytes, alignment);
+      }
+    }
+    if (!timing_enabled()) {
+      deallocate_and_count(ptr, bytes, alignment);
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    deallocate_and_count(ptr, bytes, alignment);
+    deallocate_latency_.record(elapsed_ns(start));
+  }
+
+  /// Make the given thread the owner of the pool, or remove the owner if the id is empty.
+  /**
+   * While the pool has an owner, deallocations from every other thread are queued without a
+   * lock and completed by the owner, up to remote_free_batch blocks per allocation, or all of
+   * them when an allocation would otherwise fail. With tlsf_no_lock this makes a pool safe for
+   * a producer thread that allocates and consumer threads that only deallocate.
+   * Queued blocks count as free in bytes_in_use but stay unavailable until drained.
+   * Set the owner before other threads use the pool, and drain it with
+   * drain_remote_frees() before removing the owner.
+   */
+  void set_owner_thread(std::thread::id owner = std::this_thread::get_id()) noexcept
+  {
+    owner_.store(owner, std::memory_order_release);
+  }
+
+  std::thread::id owner_thread() const noexcept
+  {
+    return owner_.load(std::memory_order_acquire);
+  }
+
+  /// Complete up to max_blocks queued deallocations. Only call this from the owner thread.
+  /// \return The number of blocks given back to TLSF.
+  size_t drain_remote_frees(size_t max_blocks = std::numeric_limits<size_t>::max())
+  {
+    size_t drained = 0;
+    for (auto & arena : arenas_) {
+      if (drained == max_blocks) {
+        break;
+      }
+      drained += drain_arena(arena, max_blocks - drained);
+    }
+    return drained;
+  }
+
+  /// Resize a block, in place if TLSF can extend or shrink it.
+  /**
+   * Otherwise the first min(old_bytes, new_bytes) bytes move to a new block, which is allocated
+   * before the old one is released. Blocks aligned beyond the natural alignment, pools with a
+   * debug policy and threads other than the owner of the pool always take that moving path.
+   * Growth that does not fit in the arena of the block is retried in the other arenas.
+   * \return The resized block, or nullptr if the pool is exhausted, in which case the old block
+   *   is left untouched.
+   */
+  void * reallocate(
+    void * ptr, size_t old_bytes, size_t new_bytes,
+    size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    if (ptr == nullptr) {
+      return allocate(new_bytes, alignment);
+    }
+    if constexpr (!DebugPolicy::enabled) {
+      if (alignment <= tlsf_cpp::detail::natural_alignment && new_bytes > 0 && !is_remote()) {
+        if (void * resized = reallocate_in_arena(ptr, old_bytes, new_bytes, alignment)) {
+          return resized;
+        }
+      }
+    }
+    void * moved = allocate(new_bytes, alignment);
+    if (moved == nullptr) {
+      return nullptr;
+    }
+    memcpy(moved, ptr, std::min(old_bytes, new_bytes));
+    deallocate(ptr, old_bytes, alignment);
+    reallocation_count_.fetch_add(1, std::memory_order_relaxed);
+    return moved;
+  }
+
+  /// Allocate count blocks of bytes each, taking each arena lock once for all of them.
+  /**
+   * All or nothing: if the pool cannot hold every block, the ones already taken are given
+   * back, blocks is filled with nullptr and a single failed allocation is counted.
+   * The latency histograms time the whole batch as one allocation.
+   * \return Whether the blocks were allocated.
+   */
+  bool allocate_batch(
+    void ** blocks, size_t count, size_t bytes,
+    size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    bool allocated;
+    if (!timing_enabled()) {
+      allocated = allocate_batch_and_count(blocks, count, bytes, alignment);
+    } else {
+      auto start = std::chrono::steady_clock::now();
+      allocated = allocate_batch_and_count(blocks, count, bytes, alignment);
+      allocate_latency_.record(elapsed_ns(start));
+    }
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      if (!allocated) {
+        recorder->record(tlsf_trace_event::failed_allocate, nullptr, bytes, alignment);
+      }
+      for (size_t i = 0; allocated && i < count; ++i) {
+        recorder->record(tlsf_trace_event::allocate, blocks[i], bytes, alignment);
+      }
+    }
+    return allocated;
+  }
+
+  /// Return count blocks of the same size and alignment, taking each arena lock once per run
+  /// of consecutive blocks from that arena. Null entries are skipped.
+  /// The latency histograms time the whole batch as one deallocation.
+  void deallocate_batch(
+    void * const * blocks, size_t count, size_t bytes,
+    size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      for (size_t i = 0; i < count; ++i) {
+        if (blocks[i] != nullptr) {
+          recorder->record(tlsf_trace_event::deallocate, blocks[i], bytes, alignment);
+        }
+      }
+    }
+    if (!timing_enabled()) {
+      deallocate_batch_and_count(blocks, count, bytes, alignment);
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    deallocate_batch_and_count(blocks, count, bytes, alignment);
+    deallocate_latency_.record(elapsed_ns(start));
+  }
+
+  /// Start or stop timing every allocate and deallocate call, and the wait and hold times of
+  /// the pool locks. Enabling adds a few clock reads to each call.
+  void enable_latency_histograms(bool enable) noexcept
+  {
+    latency_histograms_enabled_.store(enable, std::memory_order_relaxed);
+  }
+
+  /// Record every allocate and deallocate call into the given recorder, or stop recording if
+  /// it is nullptr. The recorder must outlive its use by the pool.
+  void set_trace_recorder(tlsf_trace_recorder * recorder) noexcept
+  {
+    trace_recorder_.store(recorder, std::memory_order_release);
+  }
+
+  /// Clear the latency histograms, the lock statistics and the peak usage, of the clients too.
+  void reset_stats() noexcept
+  {
+    allocate_latency_.reset();
+    deallocate_latency_.reset();
+    peak_bytes_in_use_.store(
+      bytes_in_use_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (auto & arena : arenas_) {
+      arena.max_used_size.store(
+        arena.used_size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (auto & account : clients_) {
+      account.peak_bytes_in_use.store(
+        account.bytes_in_use.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (auto counter : {&lock_acquisitions_, &lock_contentions_, &lock_total_wait_ns_,
+        &lock_max_wait_ns_, &lock_total_hold_ns_, &lock_max_hold_ns_})
+    {
+      counter->store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// Snapshot of the pool counters. Safe to call from any thread, concurrently with
+  /// allocations; the fields are read individually and may be slightly out of step.
+  tlsf_pool_stats stats() const
+  {
+    tlsf_pool_stats out;
+    out.pool_size = pool_size_;
+    for (auto & arena : arenas_) {
+      out.capacity += arena.capacity;
+      out.used_size += arena.used_size.load(std::memory_order_relaxed);
+      out.max_used_size += arena.max_used_size.load(std::memory_order_relaxed);
+    }
+    out.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    out.peak_bytes_in_use = peak_bytes_in_use_.load(std::memory_order_relaxed);
+    out.allocation_count = allocation_count_.load(std::memory_order_relaxed);
+    out.deallocation_count = deallocation_count_.load(std::memory_order_relaxed);
+    out.failed_allocation_count = failed_allocation_count_.load(std::memory_order_relaxed);
+    out.reallocation_count = reallocation_count_.load(std::memory_order_relaxed);
+    out.in_place_reallocation_count =
+      in_place_reallocation_count_.load(std::memory_order_relaxed);
+    out.remote_deallocation_count = remote_deallocation_count_.load(std::memory_order_relaxed);
+    out.pending_remote_frees = pending_remote_frees_.load(std::memory_order_relaxed);
+    out.largest_free_block = largest_free_block_.load(std::memory_order_relaxed);
+    out.fragmentation = fragmentation_.load(std::memory_order_relaxed);
+    out.inspection_count = inspection_count_.load(std::memory_order_relaxed);
+    out.trimmed_bytes = trimmed_bytes_.load(std::memory_order_relaxed);
+    allocate_latency_.snapshot(out.allocate_latency);
+    deallocate_latency_.snapshot(out.deallocate_latency);
+    out.lock.acquisitions = lock_acquisitions_.load(std::memory_order_relaxed);
+    out.lock.contended_acquisitions = lock_contentions_.load(std::memory_order_relaxed);
+    out.lock.total_wait_ns = lock_total_wait_ns_.load(std::memory_order_relaxed);
+    out.lock.max_wait_ns = lock_max_wait_ns_.load(std::memory_order_relaxed);
+    out.lock.total_hold_ns = lock_total_hold_ns_.load(std::memory_order_relaxed);
+    out.lock.max_hold_ns = lock_max_hold_ns_.load(std::memory_order_relaxed);
+    return out;
+  }
+
+  /// Measure the largest free block and the fragmentation of the pool.
+  /**
+   * The TLSF interface does not expose its free lists, so the largest block is found by
+   * binary search over trial allocations; each trial is a constant-time TLSF operation and
+   * is freed immediately, leaving the pool and its statistics as they were.
+   * Not real time safe. Each arena is locked while it is searched, so with tlsf_no_lock this
+   * must not run concurrently with other operations on the pool.
+   * The result is published for stats().
+   * \return The largest request the pool can currently satisfy.
+   */
+  size_t inspect()
+  {
+    size_t largest = 0;
+    size_t used = 0;
+    size_t capacity = 0;
+    for (auto & arena : arenas_) {
+      auto start = lock(arena);
+      largest = std::max(largest, largest_free_in(arena));
+      used += get_used_size(arena.memory);
+      unlock(arena, start);
+      capacity += arena.capacity;
+    }
+    used = std::max(used, static_cast<size_t>(bytes_in_use_.load(std::memory_order_relaxed)));
+    size_t free_bytes = used < capacity ? capacity - used : 0;
+    double fragmentation = 0.0;
+    if (free_bytes > largest) {
+      fragmentation = 1.0 - static_cast<double>(largest) / static_cast<double>(free_bytes);
+    }
+    largest_free_block_.store(largest, std::memory_order_relaxed);
+    fragmentation_.store(fragmentation, std::memory_order_relaxed);
+    inspection_count_.fetch_add(1, std::memory_order_relaxed);
+    return largest;
+  }
+
+  /// Give the pages of large free blocks back to the kernel, keeping reserve free bytes.
+  /**
+   * Meant for a maintenance thread once a burst of demand is over, never for the real-time
+   * path. The largest free blocks of each arena, down to min_block bytes, are found like in
+   * inspect() and the whole pages inside them released with madvise(MADV_DONTNEED), until only
+   * reserve of the free bytes of the pool are left untouched. Each arena is locked while it is
+   * trimmed, so with tlsf_no_lock this must not run concurrently with other operations on the
+   * pool.
+   *
+   * Released pages are faulted in again, zeroed, when allocations reach them, which is not
+   * real time safe; only trim when the demand is expected to stay low. Pages locked with mlock
+   * cannot be released, and pages of a shared memory segment stay in the segment.
+   * \return The number of bytes released, including pages that were not resident anyway.
+   */
+  size_t trim(size_t reserve = 0, size_t min_block = 64 * 1024)
+  {
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t used = 0;
+    size_t capacity = 0;
+    for (auto & arena : arenas_) {
+      used += arena.used_size.load(std::memory_order_relaxed);
+      capacity += arena.capacity;
+    }
+    used = std::max(used, static_cast<size_t>(bytes_in_use_.load(std::memory_order_relaxed)));
+    size_t free_bytes = used < capacity ? capacity - used : 0;
+    size_t budget = free_bytes > reserve ? free_bytes - reserve : 0;
+
+    size_t released = 0;
+    for (auto & arena : arenas_) {
+      if (budget < page_size) {
+        break;
+      }
+      auto start = lock(arena);
+      // The blocks are held until the arena is done, so each search finds the next largest.
+      void * blocks[max_trimmed_blocks];
+      size_t count = 0;
+      while (count < max_trimmed_blocks && budget >= page_size) {
+        size_t size = largest_free_in(arena);
+        if (size < min_block || size < page_size) {
+          break;
+        }
+        void * block = malloc_ex(size, arena.memory);
+        if (block == nullptr) {
+          break;
+        }
+        blocks[count++] = block;
+        // TLSF keeps its free list links in the first words of a free block.
+        uintptr_t first = (reinterpret_cast<uintptr_t>(block) + 4 * sizeof(void *) +
+          page_size - 1) / page_size * page_size;
+        uintptr_t last = (reinterpret_cast<uintptr_t>(block) + size) / page_size * page_size;
+        last = std::min<uintptr_t>(last, first + budget / page_size * page_size);
+        if (last > first &&
+          madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED) == 0)
+        {
+          released += last - first;
+          budget -= last - first;
+        }
+      }
+      for (size_t i = 0; i < count; ++i) {
+        free_ex(blocks[i], arena.memory);
+      }
+      unlock(arena, start);
+    }
+    trimmed_bytes_.fetch_add(released, std::memory_order_relaxed);
+    return released;
+  }
+
+  /// Check the canaries and headers of every live block.
+  /**
+   * Failures are reported to the handler of the debug policy. Not real time safe: each arena
+   * is locked while its blocks are walked, so with tlsf_no_lock this must not run concurrently
+   * with other operations on the pool. Without a debug policy, there is nothing to check.
+   * \return The number of corrupted blocks found.
+   */
+  size_t check_consistency()
+  {
+    size_t corrupted = 0;
+    if constexpr (DebugPolicy::enabled) {
+      for (auto & arena : arenas_) {
+        auto start = lock(arena);
+        corrupted += DebugPolicy::walk(arena);
+        unlock(arena, start);
+      }
+    }
+    return corrupted;
+  }
+
+  /// Whether ptr points into the memory area managed by this pool.
+  bool contains(const void * ptr) const noexcept
+  {
+    auto p = static_cast<const char *>(ptr);
+    return p >= memory_pool_ && p < memory_pool_ + pool_size_;
+  }
+
+  char * data() const noexcept
+  {
+    return memory_pool_;
+  }
+
+  size_t size() const noexcept
+  {
+    return pool_size_;
+  }
+
+  /// The lock of an arena, for lock policies that keep state of their own.
+  const LockPolicy & arena_lock(size_t arena) const noexcept
+  {
+    return arenas_[arena].lock;
+  }
+
+  /// Queued deallocations completed by the owner on each allocation.
+  static constexpr size_t remote_free_batch = 16;
+
+  /// Client IDs run from 1 to max_clients - 1; client 0 stands for untagged allocations and is
+  /// not accounted.
+  static constexpr size_t max_clients = 64;
+
+  /// Charge an allocation of bytes to a client before making it.
+  /**
+   * Real time safe and lock-free. The caller makes the allocation only if this returns true,
+   * and hands the bytes back with credit_client() when the allocation fails or is released.
+   * \return false if the client would exceed its quota, in which case the attempt is counted
+   * as rejected, or if the client is not below max_clients.
+   */
+  bool charge_client(uint32_t client, size_t bytes) noexcept
+  {
+    if (client == 0) {
+      return true;
+    }
+    if (client >= max_clients) {
+      return false;
+    }
+    client_account & account = clients_[client];
+    uint64_t in_use = account.bytes_in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t quota = account.quota.load(std::memory_order_relaxed);
+    if (quota != 0 && in_use > quota) {
+      account.bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+      account.rejected_allocation_count.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    tlsf_cpp::detail::atomic_store_max(account.peak_bytes_in_use, in_use);
+    return true;
+  }
+
+  /// Hand back bytes charged to a client with charge_client().
+  void credit_client(uint32_t client, size_t bytes) noexcept
+  {
+    if (client != 0 && client < max_clients) {
+      clients_[client].bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+  }
+
+  /// Limit the bytes a client may have allocated at once, or lift the limit with 0.
+  /// Allocations already made are not affected.
+  /// \throws std::out_of_range if the client is not between 1 and max_clients - 1.
+  void set_client_quota(uint32_t client, size_t quota)
+  {
+    check_client(client);
+    clients_[client].quota.store(quota, std::memory_order_relaxed);
+  }
+
+  /// Usage of a single client. Safe to call from any thread.
+  /// \throws std::out_of_range if the client is not between 1 and max_clients - 1.
+  tlsf_client_stats client_stats(uint32_t client) const
+  {
+    check_client(client);
+    const client_account & account = clients_[client];
+    tlsf_client_stats out;
+    out.client = client;
+    out.bytes_in_use = account.bytes_in_use.load(std::memory_order_relaxed);
+    out.peak_bytes_in_use = account.peak_bytes_in_use.load(std::memory_order_relaxed);
+    out.quota = account.quota.load(std::memory_order_relaxed);
+    out.rejected_allocation_count =
+      account.rejected_allocation_count.load(std::memory_order_relaxed);
+    return out;
+  }
+
+  /// Usage of every client that has allocated from the pool or has a quota. Not real time safe.
+  std::vector<tlsf_client_stats> client_report() const
+  {
+    std::vector<tlsf_client_stats> report;
+    for (uint32_t client = 1; client < max_clients; ++client) {
+      tlsf_client_stats stats = client_stats(client);
+      if (stats.peak_bytes_in_use != 0 || stats.quota != 0 ||
+        stats.rejected_allocation_count != 0)
+      {
+        report.push_back(stats);
+      }
+    }
+    return report;
+  }
+
+  /// Free blocks of an arena released by a single call to trim().
+  static constexpr size_t max_trimmed_blocks = 64;
+
+private:
+  // A block freed by another thread than the owner, linked through two words of the block
+  // chosen by the debug policy. TLSF blocks are never smaller than two pointers.
+  struct remote_free
+  {
+    remote_free * next;
+    size_t alignment;
+  };
+
+  // The debug state of an empty policy takes no room.
+  struct arena_type : DebugPolicy::arena_state
+  {
+    char * memory = nullptr;
+    size_t capacity = 0;
+    LockPolicy lock;
+    // Pushed by any thread, taken as a whole by the owner.
+    std::atomic<remote_free *> remote_frees{nullptr};
+    // Taken from remote_frees and not freed yet; only touched by the owner.
+    remote_free * pending = nullptr;
+    // Copy of the TLSF used size, stored under the lock after every change so that stats()
+    // can read it from any thread.
+    std::atomic<size_t> used_size{0};
+    // High-water mark of used_size. TLSF keeps its own, but the trial allocations of inspect()
+    // and trim() would raise it.
+    std::atomic<size_t> max_used_size{0};
+  };
+
+  struct client_account
+  {
+    std::atomic<uint64_t> bytes_in_use{0};
+    std::atomic<uint64_t> peak_bytes_in_use{0};
+    std::atomic<uint64_t> quota{0};
+    std::atomic<uint64_t> rejected_allocation_count{0};
+  };
+
+  static constexpr bool has_lock = !std::is_same<LockPolicy, tlsf_no_lock>::value;
+
+  static void check_client(uint32_t client)
+  {
+    if (client == 0 || client >= max_clients) {
+      throw std::out_of_range("basic_tlsf_pool: client ID out of range");
+    }
+  }
+
+  void initialize_arenas()
+  {
+    // Every arena starts on a boundary suitable for the TLSF control structure.
+    arena_stride_ = pool_size_ / arena_count / alignof(std::max_align_t) *
+      alignof(std::max_align_t);
+    for (size_t i = 0; i < arena_count; ++i) {
+      arenas_[i].memory = memory_pool_ + i * arena_stride_;
+      // init_memory_pool returns -1 if the area cannot even hold the TLSF control structure;
+      // such an arena fails every allocation.
+      size_t capacity = init_memory_pool(arena_stride_, arenas_[i].memory);
+      arenas_[i].capacity = capacity == static_cast<size_t>(-1) ? 0 : capacity;
+      if (arenas_[i].capacity > 0) {
+        update_used_size(arenas_[i]);
+      }
+    }
+  }
+
+  // Size of the largest block the arena can allocate, found by binary search over trial
+  // allocations. The arena must be locked.
+  static size_t largest_free_in(arena_type & arena) noexcept
+  {
+    size_t low = 0;
+    size_t high = arena.capacity + 1;
+    while (high - low > 1) {
+      size_t mid = low + (high - low) / 2;
+      void * probe = malloc_ex(mid, arena.memory);
+      if (probe != nullptr) {
+        free_ex(probe, arena.memory);
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  arena_type & local_arena() noexcept
+  {
+    if constexpr (arena_count == 1) {
+      return arenas_[0];
+    } else {
+      return arenas_[tlsf_cpp::detail::thread_slot() % arena_count];
+    }
+  }
+
+  arena_type & owning_arena(const void * ptr) noexcept
+  {
+    if constexpr (arena_count == 1) {
+      (void)ptr;
+      return arenas_[0];
+    } else {
+      return arenas_[static_cast<size_t>(static_cast<const char *>(ptr) - memory_pool_) /
+               arena_stride_];
+    }
+  }
+
+  bool timing_enabled() const noexcept
+  {
+    return latency_histograms_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Acquire the lock of an arena, counting contention.
+  // Returns the time of acquisition if timing is enabled.
+  std::chrono::steady_clock::time_point lock(arena_type & arena)
+  {
+    std::chrono::steady_clock::time_point acquired;
+    if constexpr (has_lock) {
+      lock_acquisitions_.fetch_add(1, std::memory_order_relaxed);
+      if (arena.lock.try_lock()) {
+        if (timing_enabled()) {
+          acquired = std::chrono::steady_clock::now();
+        }
+        return acquired;
+      }
+      lock_contentions_.fetch_add(1, std::memory_order_relaxed);
+      if (!timing_enabled()) {
+        arena.lock.lock();
+        return acquired;
+      }
+      auto start = std::chrono::steady_clock::now();
+      arena.lock.lock();
+      acquired = std::chrono::steady_clock::now();
+      uint64_t wait_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(acquired - start).count());
+      lock_total_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+      tlsf_cpp::detail::atomic_store_max(lock_max_wait_ns_, wait_ns);
+    } else {
+      (void)arena;
+    }
+    return acquired;
+  }
+
+  void unlock(arena_type & arena, std::chrono::steady_clock::time_point acquired)
+  {
+    if constexpr (has_lock) {
+      bool timed = acquired != std::chrono::steady_clock::time_point();
+      uint64_t hold_ns = timed ? elapsed_ns(acquired) : 0;
+      arena.lock.unlock();
+      if (timed) {
+        lock_total_hold_ns_.fetch_add(hold_ns, std::memory_order_relaxed);
+        tlsf_cpp::detail::atomic_store_max(lock_max_hold_ns_, hold_ns);
+      }
+    } else {
+      (void)arena;
+      (void)acquired;
+    }
+  }
+
+  // Let TLSF resize the block within its arena, moving it there if it cannot stay in place.
+  void * reallocate_in_arena(void * ptr, size_t old_bytes, size_t new_bytes, size_t alignment)
+  {
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      recorder->record(tlsf_trace_event::deallocate, ptr, old_bytes, alignment);
+    }
+    arena_type & arena = owning_arena(ptr);
+    bool timed = timing_enabled();
+    std::chrono::steady_clock::time_point begin;
+    if (timed) {
+      begin = std::chrono::steady_clock::now();
+    }
+    auto start = lock(arena);
+    void * resized = realloc_ex(ptr, new_bytes, arena.memory);
+    update_used_size(arena);
+    unlock(arena, start);
+    if (timed) {
+      allocate_latency_.record(elapsed_ns(begin));
+    }
+    if (auto recorder = trace_recorder_.load(std::memory_order_acquire)) {
+      // The block is still allocated if realloc_ex failed.
+      recorder->record(
+        tlsf_trace_event::allocate, resized != nullptr ? resized : ptr,
+        resized != nullptr ? new_bytes : old_bytes, alignment);
+    }
+    if (resized == nullptr) {
+      return nullptr;
+    }
+    reallocation_count_.fetch_add(1, std::memory_order_relaxed);
+    if (resized == ptr) {
+      in_place_reallocation_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (new_bytes >= old_bytes) {
+      uint64_t grown = new_bytes - old_bytes;
+      uint64_t in_use = bytes_in_use_.fetch_add(grown, std::memory_order_relaxed) + grown;
+      tlsf_cpp::detail::atomic_store_max(peak_bytes_in_use_, in_use);
+    } else {
+      bytes_in_use_.fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+    }
+    return resized;
+  }
+
+  // Publish the TLSF used size of the arena; the arena must be locked.
+  static void update_used_size(arena_type & arena) noexcept
+  {
+    size_t used = get_used_size(arena.memory);
+    arena.used_size.store(used, std::memory_order_relaxed);
+    if (used > arena.max_used_size.load(std::memory_order_relaxed)) {
+      arena.max_used_size.store(used, std::memory_order_relaxed);
+    }
+  }
+
+  // Take a block from TLSF; the arena must be locked.
+  void * allocate_block(arena_type & arena, size_t bytes, size_t alignment)
+  {
+    void * ptr;
+    if constexpr (DebugPolicy::enabled) {
+      size_t overhead = DebugPolicy::overhead(alignment);
+      void * raw = bytes <= std::numeric_limits<size_t>::max() - overhead ?
+        tlsf_cpp::detail::aligned_malloc(bytes + overhead, alignment, arena.memory) : nullptr;
+      ptr = raw != nullptr ? DebugPolicy::on_allocate(arena, raw, bytes, alignment) : nullptr;
+    } else {
+      ptr = tlsf_cpp::detail::aligned_malloc(bytes, alignment, arena.memory);
+    }
+    if (ptr != nullptr) {
+      update_used_size(arena);
+    }
+    return ptr;
+  }
+
+  void * allocate_from(arena_type & arena, size_t bytes, size_t alignment)
+  {
+    auto start = lock(arena);
+    void * ptr = allocate_block(arena, bytes, alignment);
+    unlock(arena, start);
+    return ptr;
+  }
+
+  // Fill blocks from index filled on under a single acquisition of the arena lock.
+  // Returns the index of the first block left unfilled.
+  size_t allocate_batch_from(
+    arena_type & arena, void ** blocks, size_t filled, size_t count, size_t bytes,
+    size_t alignment)
+  {
+    auto start = lock(arena);
+    while (filled < count) {
+      blocks[filled] = allocate_block(arena, bytes, alignment);
+      if (blocks[filled] == nullptr) {
+        break;
+      }
+      ++filled;
+    }
+    unlock(arena, start);
+    return filled;
+  }
+
+  size_t allocate_batch_from_any(
+    void ** blocks, size_t filled, size_t count, size_t bytes, size_t alignment)
+  {
+    arena_type & local = local_arena();
+    filled = allocate_batch_from(local, blocks, filled, count, bytes, alignment);
+    if constexpr (arena_count > 1) {
+      for (size_t i = 0; filled < count && i < arena_count; ++i) {
+        if (&arenas_[i] != &local) {
+          filled = allocate_batch_from(arenas_[i], blocks, filled, count, bytes, alignment);
+        }
+      }
+    }
+    return filled;
+  }
+
+  bool allocate_batch_and_count(void ** blocks, size_t count, size_t bytes, size_t alignment)
+  {
+    bool owner = is_owner();
+    if (owner) {
+      drain_remote_frees(remote_free_batch);
+    }
+    size_t filled = 0;
+    if (bytes == 0 || count <= std::numeric_limits<size_t>::max() / bytes) {
+      filled = allocate_batch_from_any(blocks, 0, count, bytes, alignment);
+      if (filled < count && owner && drain_remote_frees() > 0) {
+        filled = allocate_batch_from_any(blocks, filled, count, bytes, alignment);
+      }
+    }
+    if (filled < count) {
+      free_batch(blocks, filled, bytes, alignment);
+      std::fill(blocks, blocks + count, nullptr);
+      failed_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    allocation_count_.fetch_add(count, std::memory_order_relaxed);
+    uint64_t total = static_cast<uint64_t>(count) * bytes;
+    uint64_t in_use = bytes_in_use_.fetch_add(total, std::memory_order_relaxed) + total;
+    tlsf_cpp::detail::atomic_store_max(peak_bytes_in_use_, in_use);
+    return true;
+  }
+
+  // Give blocks back to TLSF, locking each arena once per run of blocks it owns.
+  // Returns the number of blocks that were not null.
+  size_t free_batch(void * const * blocks, size_t count, size_t bytes, size_t alignment)
+  {
+    arena_type * current = nullptr;
+    std::chrono::steady_clock::time_point start;
+    size_t freed = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (blocks[i] == nullptr) {
+        continue;
+      }
+      arena_type & arena = owning_arena(blocks[i]);
+      if (&arena != current) {
+        if (current != nullptr) {
+          unlock(*current, start);
+        }
+        current = &arena;
+        start = lock(arena);
+      }
+      free_block(arena, blocks[i], bytes, alignment);
+      ++freed;
+    }
+    if (current != nullptr) {
+      unlock(*current, start);
+    }
+    return freed;
+  }
+
+  void deallocate_batch_and_count(
+    void * const * blocks, size_t count, size_t bytes, size_t alignment)
+  {
+    size_t freed = 0;
+    if (is_remote()) {
+      for (size_t i = 0; i < count; ++i) {
+        if (blocks[i] != nullptr) {
+          push_remote_free(owning_arena(blocks[i]), blocks[i], bytes, alignment);
+          ++freed;
+        }
+      }
+      remote_deallocation_count_.fetch_add(freed, std::memory_order_relaxed);
+    } else {
+      freed = free_batch(blocks, count, bytes, alignment);
+    }
+    deallocation_count_.fetch_add(freed, std::memory_order_relaxed);
+    bytes_in_use_.fetch_sub(static_cast<uint64_t>(freed) * bytes, std::memory_order_relaxed);
+  }
+
+  void * allocate_and_count(size_t bytes, size_t alignment)
+  {
+    bool owner = is_owner();
+    if (owner) {
+      drain_remote_frees(remote_free_batch);
+    }
+    void * ptr = allocate_from_any(bytes, alignment);
+    if (ptr == nullptr && owner && drain_remote_frees() > 0) {
+      ptr = allocate_from_any(bytes, alignment);
+    }
+    if (ptr == nullptr) {
+      failed_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    allocation_count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t in_use = bytes_in_use_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    tlsf_cpp::detail::atomic_store_max(peak_bytes_in_use_, in_use);
+    return ptr;
+  }
+
+  // Give a block back to TLSF; the arena must be locked. from_queue marks blocks drained from
+  // the remote frees.
+  void free_block(
+    arena_type & arena, void * ptr, size_t bytes, size_t alignment, bool from_queue = false)
+  {
+    if constexpr (DebugPolicy::enabled) {
+      // A corrupted block is leaked rather than given back to TLSF.
+      tlsf_cpp::detail::aligned_free(
+        DebugPolicy::on_deallocate(arena, ptr, bytes, alignment, from_queue), alignment,
+        arena.memory);
+    } else {
+      (void)bytes;
+      (void)from_queue;
+      tlsf_cpp::detail::aligned_free(ptr, alignment, arena.memory);
+    }
+    update_used_size(arena);
+  }
+
+  void * allocate_from_any(size_t bytes, size_t alignment)
+  {
+    arena_type & local = local_arena();
+    void * ptr = allocate_from(local, bytes, alignment);
+    if constexpr (arena_count > 1) {
+      // Spill into the other arenas before giving up.
+      for (size_t i = 0; ptr == nullptr && i < arena_count; ++i) {
+        if (&arenas_[i] != &local) {
+          ptr = allocate_from(arenas_[i], bytes, alignment);
+        }
+      }
+    }
+    return ptr;
+  }
+
+  bool is_owner() const noexcept
+  {
+    std::thread::id owner = owner_.load(std::memory_order_relaxed);
+    return owner != std::thread::id() && owner == std::this_thread::get_id();
+  }
+
+  bool is_remote() const noexcept
+  {
+    std::thread::id owner = owner_.load(std::memory_order_relaxed);
+    return owner != std::thread::id() && owner != std::this_thread::get_id();
+  }
+
+  // Queue a block for the owner. Lock-free: a single compare-and-swap loop on the arena queue.
+  void push_remote_free(arena_type & arena, void * ptr, size_t bytes, size_t alignment)
+  {
+    if constexpr (DebugPolicy::enabled) {
+      if (!DebugPolicy::on_remote_deallocate(ptr, bytes)) {
+        return;
+      }
+    } else {
+      (void)bytes;
+    }
+    auto block = static_cast<remote_free *>(DebugPolicy::remote_link(ptr));
+    block->alignment = alignment;
+    block->next = arena.remote_frees.load(std::memory_order_relaxed);
+    while (!arena.remote_frees.compare_exchange_weak(
+        block->next, block, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    pending_remote_frees_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Free up to max_blocks queued blocks of an arena under a single lock acquisition.
+  size_t drain_arena(arena_type & arena, size_t max_blocks)
+  {
+    if (arena.pending == nullptr) {
+      if (arena.remote_frees.load(std::memory_order_relaxed) == nullptr) {
+        return 0;
+      }
+      arena.pending = arena.remote_frees.exchange(nullptr, std::memory_order_acquire);
+    }
+    size_t drained = 0;
+    auto start = lock(arena);
+    while (arena.pending != nullptr && drained < max_blocks) {
+      remote_free * block = arena.pending;
+      arena.pending = block->next;
+      void * ptr = DebugPolicy::remote_block(block);
+      free_block(arena, ptr, DebugPolicy::block_size(ptr), block->alignment, true);
+      ++drained;
+    }
+    unlock(arena, start);
+    pending_remote_frees_.fetch_sub(drained, std::memory_order_relaxed);
+    return drained;
+  }
+
+  void deallocate_and_count(void * ptr, size_t bytes, size_t alignment)
+  {
+    if (ptr == nullptr) {
+      return;
+    }
+    arena_type & arena = owning_arena(ptr);
+    if (is_remote()) {
+      push_remote_free(arena, ptr, bytes, alignment);
+      remote_deallocation_count_.fetch_add(1, std::memory_order_relaxed);
+      deallocation_count_.fetch_add(1, std::memory_order_relaxed);
+      bytes_in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+      return;
+    }
+    auto start = lock(arena);
+    free_block(arena, ptr, bytes, alignment);
+    unlock(arena, start);
+    deallocation_count_.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  static uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+  {
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+  }
+
+  char * memory_pool_;
+  size_t pool_size_;
+  size_t arena_stride_;
+  arena_type arenas_[arena_count];
+  std::atomic<size_t> refcount_;
+  bool managed_;
+  bool owns_memory_;
+
+  std::atomic<uint64_t> bytes_in_use_{0};
+  std::atomic<uint64_t> peak_bytes_in_use_{0};
+  std::atomic<uint64_t> allocation_count_{0};
+  std::atomic<uint64_t> deallocation_count_{0};
+  std::atomic<uint64_t> failed_allocation_count_{0};
+  std::atomic<uint64_t> reallocation_count_{0};
+  std::atomic<uint64_t> in_place_reallocation_count_{0};
+  std::atomic<uint64_t> remote_deallocation_count_{0};
+  std::atomic<uint64_t> pending_remote_frees_{0};
+  std::atomic<std::thread::id> owner_{std::thread::id()};
+  std::atomic<size_t> largest_free_block_{0};
+  std::atomic<double> fragmentation_{0.0};
+  std::atomic<uint64_t> inspection_count_{0};
+  std::atomic<uint64_t> trimmed_bytes_{0};
+  client_account clients_[max_clients];
+  std::atomic<bool> latency_histograms_enabled_{false};
+  std::atomic<tlsf_trace_recorder *> trace_recorder_{nullptr};
+  tlsf_cpp::detail::atomic_latency_histogram allocate_latency_;
+  tlsf_cpp::detail::atomic_latency_histogram deallocate_latency_;
+
+  std::atomic<uint64_t> lock_acquisitions_{0};
+  std::atomic<uint64_t> lock_contentions_{0};
+  std::atomic<uint64_t> lock_total_wait_ns_{0};
+  std::atomic<uint64_t> lock_max_wait_ns_{0};
+  std::atomic<uint64_t> lock_total_hold_ns_{0};
+  std::atomic<uint64_t> lock_max_hold_ns_{0};
+};
+
+/// An unsynchronized TLSF pool.
+using tlsf_pool = basic_tlsf_pool<>;
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+// The memory area of a static_tlsf_pool; a base class so that it exists before the pool.
+template<size_t Size>
+struct static_pool_storage
+{
+  alignas(std::max_align_t) char bytes[Size];
+};
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+/// A TLSF pool over Size bytes stored in the pool object itself.
+/**
+ * Declared at namespace scope, the memory lives in .bss and the pool is set up during static
+ * initialization, before main, without a single heap allocation. Constructors of other static
+ * objects in other translation units may run first; if they allocate from the pool, return it
+ * from a function holding it as a local static instead.
+ *
+ * Allocators and memory resources bind to it like to any other basic_tlsf_pool.
+ */
+template<size_t Size, typename LockPolicy = tlsf_no_lock,
+  typename DebugPolicy = tlsf_default_debug>
+class static_tlsf_pool
+  : private tlsf_cpp::detail::static_pool_storage<Size>,
+  public basic_tlsf_pool<LockPolicy, DebugPolicy>
+{
+public:
+  static_tlsf_pool()
+  : basic_tlsf_pool<LockPolicy, DebugPolicy>(this->bytes, Size)
+  {
+  }
+};
+
+#endif  // TLSF_CPP__TLSF_POOL_HPP_
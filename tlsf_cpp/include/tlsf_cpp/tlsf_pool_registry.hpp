@@ -0,0 +1,279 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Process-wide registry of named TLSF pools, so that the memory set aside for real-time use is
+// sized in one place and allocators created anywhere in the process share it.
+
+#ifndef TLSF_CPP__TLSF_POOL_REGISTRY_HPP_
+#define TLSF_CPP__TLSF_POOL_REGISTRY_HPP_
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_stats.hpp"
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+// Parse a size in bytes with an optional kb, mb or gb suffix.
+// Signs, leading whitespace and sizes that do not fit in size_t are rejected.
+inline bool parse_size(const std::string & text, size_t & size)
+{
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  size_t end = 0;
+  unsigned long long value;  // NOLINT(runtime/int)
+  try {
+    value = std::stoull(text, &end);
+  } catch (const std::exception &) {
+    return false;
+  }
+  std::string suffix = text.substr(end);
+  unsigned shift = 0;
+  if (suffix == "kb") {
+    shift = 10;
+  } else if (suffix == "mb") {
+    shift = 20;
+  } else if (suffix == "gb") {
+    shift = 30;
+  } else if (!suffix.empty() && suffix != "b") {
+    return false;
+  }
+  if (value > (std::numeric_limits<size_t>::max() >> shift)) {
+    return false;
+  }
+  size = static_cast<size_t>(value) << shift;
+  return true;
+}
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+/// Named TLSF pools, created on first use with a configured size.
+/**
+ * Sizes are configured at startup, before the pools are used, with set_size() or configure().
+ * The process-wide instance() also reads them from the TLSF_CPP_POOLS environment variable,
+ * a comma-separated list of name=size entries such as "default=8mb,sensors=512kb".
+ *
+ * A name stands for a single pool whatever lock policy it is acquired with, so the configured
+ * sizes add up to the memory set aside. The pool takes the lock policy of its first user;
+ * acquiring it with another one throws, since the pool cannot be synchronized both ways.
+ *
+ * Once the pool named "default" is configured, default-constructed tlsf_heap_allocators with a
+ * lock policy other than tlsf_no_lock bind to it instead of each creating a private pool.
+ * Allocators without a lock keep their private pools, because a shared pool would be used
+ * from different threads unsynchronized; they can still name a pool explicitly.
+ *
+ * The registry keeps every pool alive until it is destroyed itself; allocators hold their own
+ * reference, so pools in use outlive the registry. None of this is real time safe.
+ */
+class tlsf_pool_registry
+{
+public:
+  /// Name of the pool default-constructed allocators bind to.
+  static constexpr const char * default_pool_name = "default";
+
+  /// Description of a registered pool.
+  struct entry
+  {
+    std::string name;
+    size_t size;
+    /// False if the pool is only configured and nothing has used it yet.
+    bool created;
+    tlsf_pool_stats stats;
+  };
+
+  tlsf_pool_registry() = default;
+  tlsf_pool_registry(const tlsf_pool_registry &) = delete;
+  tlsf_pool_registry & operator=(const tlsf_pool_registry &) = delete;
+
+  ~tlsf_pool_registry()
+  {
+    for (auto & pool : pools_) {
+      pool.second.release(pool.second.pool);
+    }
+  }
+
+  /// The registry of the process, configured from TLSF_CPP_POOLS on first use.
+  /// \throws std::invalid_argument if the environment variable is malformed.
+  static tlsf_pool_registry & instance()
+  {
+    static tlsf_pool_registry registry(from_environment());
+    return registry;
+  }
+
+  /// Set the size of a pool that has not been created yet.
+  /// \throws std::logic_error if the pool already exists with another size.
+  void set_size(const std::string & name, size_t size)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto pool = pools_.find(name);
+    if (pool != pools_.end() && pool->second.size(pool->second.pool) != size) {
+      throw std::logic_error("tlsf_pool_registry: pool '" + name + "' is already in use");
+    }
+    sizes_[name] = size;
+  }
+
+  /// Set the sizes of several pools from a list of name=size entries separated by commas.
+  /// \throws std::invalid_argument if an entry is malformed.
+  void configure(const std::string & spec)
+  {
+    size_t begin = 0;
+    while (begin < spec.size()) {
+      size_t end = spec.find(',', begin);
+      if (end == std::string::npos) {
+        end = spec.size();
+      }
+      std::string item = spec.substr(begin, end - begin);
+      size_t equals = item.find('=');
+      size_t size = 0;
+      if (equals == 0 || equals == std::string::npos ||
+        !tlsf_cpp::detail::parse_size(item.substr(equals + 1), size))
+      {
+        throw std::invalid_argument("tlsf_pool_registry: malformed pool size '" + item + "'");
+      }
+      set_size(item.substr(0, equals), size);
+      begin = end + 1;
+    }
+  }
+
+  /// Whether a size was configured for the pool.
+  bool is_configured(const std::string & name) const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return sizes_.count(name) != 0;
+  }
+
+  /// Take a reference to the named pool, creating it on first use.
+  /**
+   * The pool gets its configured size, or default_size if none was configured.
+   * Release the reference with pool_type::release().
+   * \throws std::out_of_range if the pool is unknown and default_size is 0.
+   * \throws std::logic_error if the pool was created with another lock policy.
+   */
+  template<typename LockPolicy = tlsf_no_lock>
+  basic_tlsf_pool<LockPolicy> & acquire(const std::string & name, size_t default_size = 0)
+  {
+    using pool_type = basic_tlsf_pool<LockPolicy>;
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto existing = pools_.find(name);
+    if (existing != pools_.end()) {
+      if (existing->second.type != std::type_index(typeid(pool_type))) {
+        throw std::logic_error(
+          "tlsf_pool_registry: pool '" + name + "' is in use with another lock policy");
+      }
+      auto pool = static_cast<pool_type *>(existing->second.pool);
+      pool->retain();
+      return *pool;
+    }
+    auto configured = sizes_.find(name);
+    size_t size = configured != sizes_.end() ? configured->second : default_size;
+    if (size == 0) {
+      throw std::out_of_range("tlsf_pool_registry: no size configured for pool '" + name + "'");
+    }
+    pool_type * pool = pool_type::create(size);
+    sizes_[name] = size;
+    pools_.emplace(name, pool_record::make(pool));
+    pool->retain();
+    return *pool;
+  }
+
+  /// All configured or created pools, in name order.
+  std::vector<entry> pools() const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::vector<entry> out;
+    for (const auto & size : sizes_) {
+      auto pool = pools_.find(size.first);
+      entry item{size.first, size.second, pool != pools_.end(), tlsf_pool_stats()};
+      if (item.created) {
+        item.stats = pool->second.stats(pool->second.pool);
+      }
+      out.push_back(item);
+    }
+    return out;
+  }
+
+  /// Memory of all pools created so far, in bytes.
+  size_t total_size() const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t total = 0;
+    for (const auto & pool : pools_) {
+      total += pool.second.size(pool.second.pool);
+    }
+    return total;
+  }
+
+private:
+  // A pool of any lock policy, with the operations the registry needs on it.
+  struct pool_record
+  {
+    void * pool;
+    std::type_index type;
+    void (* release)(void *);
+    size_t (* size)(const void *);
+    tlsf_pool_stats (* stats)(const void *);
+
+    template<typename Pool>
+    static pool_record make(Pool * pool)
+    {
+      return {
+        pool, std::type_index(typeid(Pool)),
+        [](void * p) {static_cast<Pool *>(p)->release();},
+        [](const void * p) {return static_cast<const Pool *>(p)->size();},
+        [](const void * p) {return static_cast<const Pool *>(p)->stats();}};
+    }
+  };
+
+  static tlsf_pool_registry * from_environment()
+  {
+    auto registry = new tlsf_pool_registry();
+    const char * spec = getenv("TLSF_CPP_POOLS");
+    if (spec != nullptr) {
+      try {
+        registry->configure(spec);
+      } catch (...) {
+        delete registry;
+        throw;
+      }
+    }
+    return registry;
+  }
+
+  explicit tlsf_pool_registry(tlsf_pool_registry * configured)
+  : sizes_(std::move(configured->sizes_))
+  {
+    delete configured;
+  }
+
+  mutable std::mutex mutex_;
+  std::map<std::string, size_t> sizes_;
+  std::map<std::string, pool_record> pools_;
+};
+
+#endif  // TLSF_CPP__TLSF_POOL_REGISTRY_HPP_
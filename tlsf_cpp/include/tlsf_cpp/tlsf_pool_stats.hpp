@@ -0,0 +1,186 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Usage statistics and latency histograms for TLSF pools.
+
+#ifndef TLSF_CPP__TLSF_POOL_STATS_HPP_
+#define TLSF_CPP__TLSF_POOL_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Distribution of operation latencies in power-of-two nanosecond buckets.
+struct tlsf_latency_histogram
+{
+  static constexpr size_t bucket_count = 32;
+
+  // buckets[i] counts operations that took less than 2^(i + 1) ns and at least 2^i ns.
+  // Bucket 0 also counts operations that took no measurable time.
+  std::array<uint64_t, bucket_count> buckets{};
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  /// Upper bound of the bucket containing the given fraction (0 to 1) of all operations.
+  uint64_t percentile_upper_bound_ns(double fraction) const
+  {
+    uint64_t threshold = static_cast<uint64_t>(fraction * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+      seen += buckets[i];
+      if (seen > 0 && seen >= threshold) {
+        return uint64_t(1) << (i + 1);
+      }
+    }
+    return max_ns;
+  }
+};
+
+/// Contention on the locks of a pool. Always zero for pools without a lock.
+struct tlsf_lock_stats
+{
+  uint64_t acquisitions = 0;
+  /// Acquisitions that found the lock held and had to wait for it.
+  uint64_t contended_acquisitions = 0;
+
+  // Only measured while latency histograms are enabled on the pool.
+  uint64_t total_wait_ns = 0;
+  uint64_t max_wait_ns = 0;
+  uint64_t total_hold_ns = 0;
+  uint64_t max_hold_ns = 0;
+};
+
+/// Usage of a pool by one client, see basic_tlsf_pool::charge_client().
+struct tlsf_client_stats
+{
+  uint32_t client = 0;
+  /// Bytes charged to the client and not yet returned.
+  size_t bytes_in_use = 0;
+  /// High-water mark of bytes_in_use.
+  size_t peak_bytes_in_use = 0;
+  /// Hard limit on bytes_in_use, or 0 for none.
+  size_t quota = 0;
+  /// Allocations refused because they would have exceeded the quota.
+  uint64_t rejected_allocation_count = 0;
+};
+
+/// Snapshot of the state of a TLSF pool.
+struct tlsf_pool_stats
+{
+  /// Size of the memory area given to the pool.
+  size_t pool_size = 0;
+  /// Bytes available for allocation after the TLSF control structures.
+  size_t capacity = 0;
+  /// Bytes used as reported by TLSF, including block overhead.
+  /// Zero if the tlsf library was built without TLSF_STATISTIC.
+  size_t used_size = 0;
+  /// High-water mark of used_size; zero under the same condition.
+  size_t max_used_size = 0;
+  /// Bytes requested by callers and not yet returned.
+  size_t bytes_in_use = 0;
+  /// High-water mark of bytes_in_use.
+  size_t peak_bytes_in_use = 0;
+
+  uint64_t allocation_count = 0;
+  uint64_t deallocation_count = 0;
+  uint64_t failed_allocation_count = 0;
+  /// Calls to reallocate() that resized a block, and how many of them did so in place.
+  uint64_t reallocation_count = 0;
+  uint64_t in_place_reallocation_count = 0;
+  /// Deallocations by other threads than the owner, queued for it to complete; see
+  /// basic_tlsf_pool::set_owner_thread().
+  uint64_t remote_deallocation_count = 0;
+  /// Queued deallocations the owner has not given back to TLSF yet.
+  uint64_t pending_remote_frees = 0;
+
+  /// Largest single request the pool could satisfy at the last inspection.
+  size_t largest_free_block = 0;
+  /// 1 - largest_free_block / free bytes at the last inspection: 0 when all free memory is
+  /// contiguous, approaching 1 as it gets split into small blocks.
+  double fragmentation = 0.0;
+  /// Number of inspections performed so far; the two fields above are meaningless while zero.
+  uint64_t inspection_count = 0;
+  /// Bytes given back to the kernel by trim() so far.
+  uint64_t trimmed_bytes = 0;
+
+  /// Only populated while latency histograms are enabled on the pool.
+  tlsf_latency_histogram allocate_latency;
+  tlsf_latency_histogram deallocate_latency;
+
+  tlsf_lock_stats lock;
+};
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+inline void atomic_store_max(std::atomic<uint64_t> & target, uint64_t value)
+{
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+    !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+// Lock-free histogram that can be recorded on the real-time path and read from any thread.
+class atomic_latency_histogram
+{
+public:
+  void record(uint64_t ns)
+  {
+    size_t bucket = 0;
+    while (bucket + 1 < tlsf_latency_histogram::bucket_count && (ns >> (bucket + 1)) != 0) {
+      ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    atomic_store_max(max_ns_, ns);
+  }
+
+  void snapshot(tlsf_latency_histogram & out) const
+  {
+    for (size_t i = 0; i < tlsf_latency_histogram::bucket_count; ++i) {
+      out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    out.count = count_.load(std::memory_order_relaxed);
+    out.total_ns = total_ns_.load(std::memory_order_relaxed);
+    out.max_ns = max_ns_.load(std::memory_order_relaxed);
+  }
+
+  void reset()
+  {
+    for (auto & bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, tlsf_latency_histogram::bucket_count> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+#endif  // TLSF_CPP__TLSF_POOL_STATS_HPP_
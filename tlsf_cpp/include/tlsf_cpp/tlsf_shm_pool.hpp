@@ -0,0 +1,580 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A TLSF pool in a named POSIX shared memory segment, for passing large messages between
+// processes by handle instead of copying them.
+
+#ifndef TLSF_CPP__TLSF_SHM_POOL_HPP_
+#define TLSF_CPP__TLSF_SHM_POOL_HPP_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+/// A block of a shared memory pool, as an offset from the start of the segment.
+/**
+ * Unlike a pointer, a handle can be sent to another process, e.g. over a socket or a message
+ * queue, and checked there before use: basic_tlsf_shm_pool::get() rejects handles pointing
+ * outside the pool.
+ */
+template<typename T>
+struct tlsf_shm_handle
+{
+  uint64_t offset = 0;
+
+  explicit operator bool() const noexcept
+  {
+    return offset != 0;
+  }
+};
+
+template<typename T>
+bool operator==(tlsf_shm_handle<T> a, tlsf_shm_handle<T> b) noexcept
+{
+  return a.offset == b.offset;
+}
+
+template<typename T>
+bool operator!=(tlsf_shm_handle<T> a, tlsf_shm_handle<T> b) noexcept
+{
+  return a.offset != b.offset;
+}
+
+struct tlsf_shm_options
+{
+  /// Address at which every process maps the segment. nullptr lets the creator pick one,
+  /// which other processes may not have free; a fixed address is safer across programs.
+  void * base_address = nullptr;
+  /// Lock the segment into RAM.
+  bool lock_memory = true;
+  /// Fault in every page of the segment when mapping it.
+  bool prefault = true;
+  /// How long open() waits for another process to finish creating the segment.
+  std::chrono::milliseconds open_timeout{1000};
+  /// Permissions of a new segment.
+  mode_t mode = 0600;
+};
+
+/// A TLSF pool shared between processes through a named POSIX shared memory segment.
+/**
+ * The segment holds a small header, the basic_tlsf_pool itself with its locks and counters,
+ * and the memory area it manages. Allocation and deallocation are the bounded-time pool
+ * operations in every process; the lock policy must work across processes, which the default
+ * tlsf_robust_pi_mutex does.
+ *
+ * TLSF links its blocks with plain pointers, so every process maps the segment at the same
+ * address, recorded in the header by the creator; opening the segment fails if that address
+ * is taken. Blocks cross process boundaries as tlsf_shm_handle, which the receiver turns back
+ * into a pointer with get().
+ *
+ * Crash recovery:
+ * - A process dying while holding a pool lock does not block the others: the next process
+ *   takes the lock over and owner_deaths() counts it. The arena the dead process was
+ *   changing may be inconsistent; check it with check_consistency() under tlsf_debug_checks,
+ *   or reset() the pool once no other process uses it.
+ * - The segment outlives its creator. A restarted creator calling open_or_create() attaches
+ *   to the existing pool, so the handles held by the survivors stay valid.
+ * - If the creator died before finishing the initialization, open_or_create() takes over and
+ *   initializes the segment itself.
+ * Blocks owned by a dead process are not reclaimed until reset().
+ *
+ * Trace recorders and owner threads are local to a process and must not be set on the pool.
+ */
+template<typename LockPolicy = tlsf_robust_pi_mutex, typename DebugPolicy = tlsf_default_debug>
+class basic_tlsf_shm_pool
+{
+public:
+  using pool_type = basic_tlsf_pool<LockPolicy, DebugPolicy>;
+
+  /// Create a new segment of size bytes, pool overhead included. Not real time safe.
+  /// \throws std::system_error if the segment exists or cannot be created, mapped or locked.
+  static basic_tlsf_shm_pool create(
+    const std::string & name, size_t size, const tlsf_shm_options & options = {})
+  {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, options.mode);
+    if (fd < 0) {
+      throw_errno("shm_open");
+    }
+    return basic_tlsf_shm_pool(name, fd, size, options, false);
+  }
+
+  /// Map an existing segment, waiting up to options.open_timeout for its creator to finish.
+  /// Not real time safe.
+  /// \throws std::system_error if the segment does not exist or cannot be mapped, and
+  ///   std::runtime_error if it is not initialized in time or was created with other policies.
+  static basic_tlsf_shm_pool open(
+    const std::string & name, const tlsf_shm_options & options = {})
+  {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      throw_errno("shm_open");
+    }
+    return basic_tlsf_shm_pool(name, fd, 0, options, true);
+  }
+
+  /// Map the segment if it exists, taking over its initialization if its creator died before
+  /// finishing it, and create it with size bytes otherwise. Not real time safe.
+  static basic_tlsf_shm_pool open_or_create(
+    const std::string & name, size_t size, const tlsf_shm_options & options = {})
+  {
+    while (true) {
+      int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, options.mode);
+      if (fd >= 0) {
+        return basic_tlsf_shm_pool(name, fd, size, options, false);
+      }
+      if (errno != EEXIST) {
+        throw_errno("shm_open");
+      }
+      fd = shm_open(name.c_str(), O_RDWR, 0);
+      if (fd >= 0) {
+        return basic_tlsf_shm_pool(name, fd, size, options, true);
+      }
+      // Unlinked in between; try creating it again.
+      if (errno != ENOENT) {
+        throw_errno("shm_open");
+      }
+    }
+  }
+
+  /// Remove the name of a segment. Processes that mapped it keep using it.
+  static bool unlink(const std::string & name) noexcept
+  {
+    return shm_unlink(name.c_str()) == 0;
+  }
+
+  basic_tlsf_shm_pool(basic_tlsf_shm_pool && other) noexcept
+  : name_(std::move(other.name_)), base_(std::exchange(other.base_, nullptr)),
+    size_(other.size_), created_(other.created_)
+  {
+  }
+
+  basic_tlsf_shm_pool & operator=(basic_tlsf_shm_pool && other) noexcept
+  {
+    if (this != &other) {
+      unmap();
+      name_ = std::move(other.name_);
+      base_ = std::exchange(other.base_, nullptr);
+      size_ = other.size_;
+      created_ = other.created_;
+    }
+    return *this;
+  }
+
+  basic_tlsf_shm_pool(const basic_tlsf_shm_pool &) = delete;
+  basic_tlsf_shm_pool & operator=(const basic_tlsf_shm_pool &) = delete;
+
+  /// Unmap the segment. The pool stays in it for the other processes; see unlink().
+  ~basic_tlsf_shm_pool()
+  {
+    unmap();
+  }
+
+  /// Allocate from the shared pool, see basic_tlsf_pool::allocate.
+  void * allocate(size_t bytes, size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    return pool().allocate(bytes, alignment);
+  }
+
+  /// Return a block to the shared pool; any process may free blocks of any other.
+  void deallocate(
+    void * ptr, size_t bytes, size_t alignment = tlsf_cpp::detail::natural_alignment)
+  {
+    pool().deallocate(ptr, bytes, alignment);
+  }
+
+  /// The handle of a block of the pool, or an empty handle for nullptr.
+  template<typename T>
+  tlsf_shm_handle<T> to_handle(const T * ptr) const noexcept
+  {
+    if (ptr == nullptr) {
+      return {};
+    }
+    return {static_cast<uint64_t>(reinterpret_cast<const char *>(ptr) - base_)};
+  }
+
+  /// The block a handle refers to, or nullptr if the handle is empty or a T at its offset
+  /// would not lie within the memory area of the pool.
+  template<typename T>
+  T * get(tlsf_shm_handle<T> handle) const noexcept
+  {
+    uint64_t begin = header().memory_offset;
+    if (handle.offset < begin || handle.offset > size_ || size_ - handle.offset < sizeof(T)) {
+      return nullptr;
+    }
+    return reinterpret_cast<T *>(base_ + handle.offset);
+  }
+
+  pool_type & pool() const noexcept
+  {
+    return *reinterpret_cast<pool_type *>(base_ + header().pool_offset);
+  }
+
+  tlsf_pool_stats stats() const
+  {
+    return pool().stats();
+  }
+
+  /// Number of pool locks taken over from processes that died holding them.
+  uint64_t owner_deaths() const noexcept
+  {
+    uint64_t deaths = 0;
+    for (size_t i = 0; i < pool_type::arena_count; ++i) {
+      deaths += pool().arena_lock(i).owner_deaths();
+    }
+    return deaths;
+  }
+
+  /// Reinitialize the pool, freeing every block and clearing the counters.
+  /**
+   * Only safe while no other process uses the segment, e.g. from a supervisor that restarted
+   * every client after one of them crashed. Not real time safe.
+   */
+  void reset()
+  {
+    segment_header & head = header();
+    pool().~pool_type();
+    new (base_ + head.pool_offset) pool_type(
+      base_ + head.memory_offset, size_ - head.memory_offset);
+  }
+
+  /// Whether this process initialized the segment, as opposed to attaching to it.
+  bool created() const noexcept
+  {
+    return created_;
+  }
+
+  const std::string & name() const noexcept
+  {
+    return name_;
+  }
+
+  /// Address of the segment, the same in every process.
+  void * base() const noexcept
+  {
+    return base_;
+  }
+
+  /// Size of the segment, including the header and the pool structure.
+  size_t size() const noexcept
+  {
+    return size_;
+  }
+
+private:
+  static constexpr uint64_t segment_magic = 0x544c5346534d4831ULL;  // "TLSFSMH1"
+
+  // Initialization phases, kept with the pid of the initializing process in one word.
+  enum phase : uint64_t
+  {
+    phase_empty = 0,
+    phase_initializing = 1,
+    phase_ready = 2,
+  };
+
+  struct segment_header
+  {
+    std::atomic<uint64_t> state;
+    uint64_t magic;
+    // Catches processes built with other policies or another version of the pool.
+    uint64_t pool_type_size;
+    uint64_t arena_count;
+    uint64_t base_address;
+    uint64_t size;
+    uint64_t pool_offset;
+    uint64_t memory_offset;
+  };
+
+  static constexpr uint64_t make_state(pid_t pid, phase current) noexcept
+  {
+    return static_cast<uint64_t>(pid) << 2 | current;
+  }
+
+  static constexpr size_t align_up(size_t value, size_t alignment) noexcept
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  static constexpr size_t pool_offset =
+    align_up(sizeof(segment_header), alignof(pool_type));
+  static constexpr size_t memory_offset =
+    align_up(pool_offset + sizeof(pool_type), alignof(std::max_align_t));
+
+  [[noreturn]] static void throw_errno(const char * what)
+  {
+    throw std::system_error(
+            errno, std::generic_category(), std::string("tlsf_shm_pool: ") + what);
+  }
+
+  static bool process_alive(pid_t pid) noexcept
+  {
+    return kill(pid, 0) == 0 || errno == EPERM;
+  }
+
+  // Takes ownership of fd. existing: the segment was opened rather than created; size is then
+  // only used to take over an abandoned initialization, and zero forbids it.
+  basic_tlsf_shm_pool(
+    const std::string & name, int fd, size_t size, const tlsf_shm_options & options,
+    bool existing)
+  : name_(name), base_(nullptr), size_(0), created_(false)
+  {
+    try {
+      if (existing) {
+        attach(fd, size, options);
+      } else {
+        initialize(fd, size, options, false);
+      }
+    } catch (...) {
+      unmap();
+      close(fd);
+      throw;
+    }
+    close(fd);
+  }
+
+  void map(int fd, void * address, size_t size, const tlsf_shm_options & options)
+  {
+    int flags = MAP_SHARED;
+    if (options.prefault) {
+      flags |= MAP_POPULATE;
+    }
+#ifdef MAP_FIXED_NOREPLACE
+    if (address != nullptr) {
+      flags |= MAP_FIXED_NOREPLACE;
+    }
+#endif
+    void * mapped = mmap(address, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (mapped == MAP_FAILED) {
+      throw_errno("mmap");
+    }
+    base_ = static_cast<char *>(mapped);
+    size_ = size;
+    // Without MAP_FIXED_NOREPLACE the address is only a hint.
+    if (address != nullptr && mapped != address) {
+      unmap();
+      throw std::runtime_error(
+              "tlsf_shm_pool: the segment address is already in use in this process");
+    }
+    if (options.lock_memory && mlock(base_, size_) != 0) {
+      throw_errno("mlock");
+    }
+  }
+
+  void unmap() noexcept
+  {
+    if (base_ != nullptr) {
+      munmap(base_, size_);
+      base_ = nullptr;
+    }
+  }
+
+  segment_header & header() const noexcept
+  {
+    return *reinterpret_cast<segment_header *>(base_);
+  }
+
+  // claimed: the initializing state was already set by this process.
+  void initialize(int fd, size_t size, const tlsf_shm_options & options, bool claimed)
+  {
+    if (size <= memory_offset) {
+      throw std::invalid_argument("tlsf_shm_pool: segment too small for the pool structure");
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      throw_errno("ftruncate");
+    }
+    map(fd, options.base_address, size, options);
+    segment_header & head = header();
+    uint64_t expected = make_state(0, phase_empty);
+    if (!claimed && !head.state.compare_exchange_strong(
+        expected, make_state(getpid(), phase_initializing), std::memory_order_acq_rel))
+    {
+      throw std::runtime_error("tlsf_shm_pool: another process took over the initialization");
+    }
+    head.magic = segment_magic;
+    head.pool_type_size = sizeof(pool_type);
+    head.arena_count = pool_type::arena_count;
+    head.base_address = reinterpret_cast<uintptr_t>(base_);
+    head.size = size;
+    head.pool_offset = pool_offset;
+    head.memory_offset = memory_offset;
+    new (base_ + pool_offset) pool_type(base_ + memory_offset, size - memory_offset);
+    head.state.store(make_state(getpid(), phase_ready), std::memory_order_release);
+    created_ = true;
+  }
+
+  void attach(int fd, size_t takeover_size, const tlsf_shm_options & options)
+  {
+    auto deadline = std::chrono::steady_clock::now() + options.open_timeout;
+    size_t header_size = align_up(sizeof(segment_header), static_cast<size_t>(getpagesize()));
+    segment_header * head = nullptr;
+    while (head == nullptr) {
+      struct stat status;
+      if (fstat(fd, &status) != 0) {
+        throw_errno("fstat");
+      }
+      bool expired = std::chrono::steady_clock::now() >= deadline;
+      if (static_cast<size_t>(status.st_size) >= header_size) {
+        void * mapped = mmap(nullptr, header_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+          throw_errno("mmap");
+        }
+        head = static_cast<segment_header *>(mapped);
+      } else if (expired && takeover_size != 0) {
+        // The creator never sized the segment.
+        if (ftruncate(fd, static_cast<off_t>(takeover_size)) != 0) {
+          throw_errno("ftruncate");
+        }
+      } else if (expired) {
+        throw std::runtime_error("tlsf_shm_pool: the segment was never initialized");
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+    uint64_t state;
+    while (((state = head->state.load(std::memory_order_acquire)) & 3) != phase_ready) {
+      bool expired = std::chrono::steady_clock::now() >= deadline;
+      pid_t initializer = static_cast<pid_t>(state >> 2);
+      bool abandoned = (state & 3) == phase_initializing ? !process_alive(initializer) : expired;
+      if (takeover_size != 0 && abandoned) {
+        if (head->state.compare_exchange_strong(
+            state, make_state(getpid(), phase_initializing), std::memory_order_acq_rel))
+        {
+          munmap(head, header_size);
+          initialize(fd, takeover_size, options, true);
+          return;
+        }
+        continue;
+      }
+      if (expired) {
+        munmap(head, header_size);
+        throw std::runtime_error("tlsf_shm_pool: the segment was not initialized in time");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bool compatible = head->magic == segment_magic &&
+      head->pool_type_size == sizeof(pool_type) && head->arena_count == pool_type::arena_count;
+    void * address = reinterpret_cast<void *>(static_cast<uintptr_t>(head->base_address));
+    size_t size = head->size;
+    munmap(head, header_size);
+    if (!compatible) {
+      throw std::runtime_error("tlsf_shm_pool: the segment holds a pool of another type");
+    }
+    map(fd, address, size, options);
+  }
+
+  std::string name_;
+  char * base_;
+  size_t size_;
+  bool created_;
+};
+
+/// A shared memory pool locked with a robust, process-shared priority inheritance mutex.
+using tlsf_shm_pool = basic_tlsf_shm_pool<>;
+
+/// Allocator over a basic_tlsf_shm_pool, which must outlive it.
+/**
+ * Besides the std::allocator_traits interface, it hands out blocks as tlsf_shm_handle so that
+ * they can be passed to other processes mapping the same pool.
+ */
+template<typename T, typename ShmPool = tlsf_shm_pool>
+struct tlsf_shm_allocator
+{
+  // Needed for std::allocator_traits
+  using value_type = T;
+
+  explicit tlsf_shm_allocator(ShmPool & shm_pool) noexcept
+  : pool(&shm_pool)
+  {
+  }
+
+  // Needed for std::allocator_traits
+  template<typename U>
+  tlsf_shm_allocator(const tlsf_shm_allocator<U, ShmPool> & alloc) noexcept
+  : pool(alloc.pool)
+  {
+  }
+
+  // Needed for std::allocator_traits
+  T * allocate(size_t size)
+  {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    T * ptr = static_cast<T *>(pool->allocate(size * sizeof(T), alignof(T)));
+    if (ptr == nullptr && size > 0) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  // Needed for std::allocator_traits
+  void deallocate(T * ptr, size_t size)
+  {
+    pool->deallocate(ptr, size * sizeof(T), alignof(T));
+  }
+
+  // Allocate storage for size objects and return it as a handle for another process.
+  tlsf_shm_handle<T> allocate_handle(size_t size = 1)
+  {
+    return pool->to_handle(allocate(size));
+  }
+
+  // Release storage received as a handle, possibly allocated by another process.
+  void deallocate(tlsf_shm_handle<T> handle, size_t size = 1)
+  {
+    deallocate(pool->get(handle), size);
+  }
+
+  template<typename U>
+  struct rebind
+  {
+    typedef tlsf_shm_allocator<U, ShmPool> other;
+  };
+
+  ShmPool * pool;
+};
+
+// Needed for std::allocator_traits
+template<typename T, typename U, typename P>
+bool operator==(const tlsf_shm_allocator<T, P> & a, const tlsf_shm_allocator<U, P> & b) noexcept
+{
+  return a.pool == b.pool;
+}
+
+// Needed for std::allocator_traits
+template<typename T, typename U, typename P>
+bool operator!=(const tlsf_shm_allocator<T, P> & a, const tlsf_shm_allocator<U, P> & b) noexcept
+{
+  return a.pool != b.pool;
+}
+
+#endif  // TLSF_CPP__TLSF_SHM_POOL_HPP_
@@ -0,0 +1,198 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Recording of the allocations made from a TLSF pool, so that pools can be sized and
+// compared against other allocators offline, see tlsf_trace_replay.hpp.
+
+#ifndef TLSF_CPP__TLSF_TRACE_HPP_
+#define TLSF_CPP__TLSF_TRACE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+
+/// A single allocator call.
+struct tlsf_trace_event
+{
+  enum type_t : uint32_t
+  {
+    allocate = 0,
+    deallocate = 1,
+    /// An allocation the pool could not satisfy; address is 0.
+    failed_allocate = 2,
+  };
+
+  /// steady_clock time of the call.
+  uint64_t timestamp_ns;
+  uint64_t address;
+  uint64_t size;
+  uint32_t alignment;
+  /// Index of the calling thread, assigned in order of first use.
+  uint32_t thread;
+  type_t type;
+};
+
+/// Write events as text, one per line.
+inline void tlsf_write_trace(std::ostream & out, const std::vector<tlsf_trace_event> & events)
+{
+  static const char type_names[] = {'a', 'd', 'f'};
+  out << "# tlsf_cpp trace v1\n";
+  out << "# timestamp_ns thread type address size alignment\n";
+  for (const auto & event : events) {
+    out << event.timestamp_ns << " " << event.thread << " " << type_names[event.type] << " " <<
+      std::hex << event.address << std::dec << " " << event.size << " " << event.alignment <<
+      "\n";
+  }
+}
+
+/// A preallocated ring of allocator events.
+/**
+ * record() is real time safe and may be called from any number of threads; once the ring is
+ * full the oldest events are overwritten. Events recorded while snapshot() or dump() run may be
+ * torn, so stop recording, e.g. with basic_tlsf_pool::set_trace_recorder(nullptr), first.
+ */
+class tlsf_trace_recorder
+{
+public:
+  /// Preallocate room for capacity events. Not real time safe.
+  explicit tlsf_trace_recorder(size_t capacity)
+  : events_(new tlsf_trace_event[capacity]), capacity_(capacity)
+  {
+  }
+
+  tlsf_trace_recorder(const tlsf_trace_recorder &) = delete;
+  tlsf_trace_recorder & operator=(const tlsf_trace_recorder &) = delete;
+
+  void record(
+    tlsf_trace_event::type_t type, const void * address, size_t size, size_t alignment) noexcept
+  {
+    if (capacity_ == 0) {
+      return;
+    }
+    uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    tlsf_trace_event & event = events_[index % capacity_];
+    event.timestamp_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    event.address = reinterpret_cast<uintptr_t>(address);
+    event.size = size;
+    event.alignment = static_cast<uint32_t>(alignment);
+    event.thread = static_cast<uint32_t>(tlsf_cpp::detail::thread_slot());
+    event.type = type;
+  }
+
+  /// Total number of events recorded, including overwritten ones.
+  uint64_t recorded() const noexcept
+  {
+    return next_.load(std::memory_order_relaxed);
+  }
+
+  /// Number of events lost because the ring was full.
+  uint64_t overwritten() const noexcept
+  {
+    uint64_t count = recorded();
+    return count > capacity_ ? count - capacity_ : 0;
+  }
+
+  size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  /// Drop all events.
+  void clear() noexcept
+  {
+    next_.store(0, std::memory_order_relaxed);
+  }
+
+  /// Copy the retained events, oldest first. Not real time safe.
+  std::vector<tlsf_trace_event> snapshot() const
+  {
+    uint64_t count = recorded();
+    uint64_t first = count > capacity_ ? count - capacity_ : 0;
+    std::vector<tlsf_trace_event> out;
+    out.reserve(static_cast<size_t>(count - first));
+    for (uint64_t i = first; i < count; ++i) {
+      out.push_back(events_[i % capacity_]);
+    }
+    return out;
+  }
+
+  /// Write the retained events in the text format read by tlsf_read_trace().
+  void dump(std::ostream & out) const
+  {
+    tlsf_write_trace(out, snapshot());
+  }
+
+private:
+  std::unique_ptr<tlsf_trace_event[]> events_;
+  size_t capacity_;
+  std::atomic<uint64_t> next_{0};
+};
+
+/// Read a trace written by tlsf_trace_recorder::dump().
+/**
+ * Lines starting with # are ignored.
+ * \return false if a line could not be parsed; the events read so far are kept.
+ */
+inline bool tlsf_read_trace(std::istream & in, std::vector<tlsf_trace_event> & events)
+{
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    tlsf_trace_event event{};
+    char type[2] = {0, 0};
+    unsigned long long timestamp = 0, address = 0, size = 0;  // NOLINT(runtime/int)
+    unsigned int thread = 0, alignment = 0;
+    if (sscanf(
+        line.c_str(), "%llu %u %1s %llx %llu %u", &timestamp, &thread, type, &address,
+        &size, &alignment) != 6)
+    {
+      return false;
+    }
+    switch (type[0]) {
+      case 'a':
+        event.type = tlsf_trace_event::allocate;
+        break;
+      case 'd':
+        event.type = tlsf_trace_event::deallocate;
+        break;
+      case 'f':
+        event.type = tlsf_trace_event::failed_allocate;
+        break;
+      default:
+        return false;
+    }
+    event.timestamp_ns = timestamp;
+    event.thread = thread;
+    event.address = address;
+    event.size = size;
+    event.alignment = alignment;
+    events.push_back(event);
+  }
+  return true;
+}
+
+#endif  // TLSF_CPP__TLSF_TRACE_HPP_
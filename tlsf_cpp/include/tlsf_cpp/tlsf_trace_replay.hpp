@@ -0,0 +1,229 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Offline replay of recorded allocation traces against TLSF pools of various sizes and against
+// any std::pmr::memory_resource. None of this is real time safe.
+
+#ifndef TLSF_CPP__TLSF_TRACE_REPLAY_HPP_
+#define TLSF_CPP__TLSF_TRACE_REPLAY_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_memory_resource.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_stats.hpp"
+#include "tlsf_cpp/tlsf_trace.hpp"
+
+/// State of a TLSF pool at one point of a replay.
+struct tlsf_replay_sample
+{
+  /// Index of the trace event after which the sample was taken.
+  uint64_t event_index = 0;
+  size_t bytes_in_use = 0;
+  size_t largest_free_block = 0;
+  double fragmentation = 0.0;
+};
+
+/// Outcome of replaying a trace against one allocator.
+struct tlsf_replay_result
+{
+  uint64_t allocation_count = 0;
+  uint64_t deallocation_count = 0;
+  /// Allocations the replayed allocator could not satisfy.
+  uint64_t failed_allocation_count = 0;
+  /// Frees of blocks allocated before the trace starts, e.g. because the ring wrapped around.
+  uint64_t unmatched_deallocation_count = 0;
+  /// Allocations that already failed when the trace was recorded; they are not replayed.
+  uint64_t skipped_failed_allocation_count = 0;
+
+  /// High-water mark of the bytes requested and not yet freed.
+  size_t peak_bytes_in_use = 0;
+  /// Worst fragmentation over the timeline; only measured for TLSF pools.
+  double max_fragmentation = 0.0;
+
+  tlsf_latency_histogram allocate_latency;
+  tlsf_latency_histogram deallocate_latency;
+
+  /// Only filled in for TLSF pools.
+  std::vector<tlsf_replay_sample> timeline;
+};
+
+namespace tlsf_cpp
+{
+namespace detail
+{
+
+// Replay the events in order, calling sample(result, index, bytes_in_use) every
+// sample_interval events and after the last one.
+inline tlsf_replay_result replay_trace(
+  const std::vector<tlsf_trace_event> & events, std::pmr::memory_resource & resource,
+  size_t sample_interval,
+  const std::function<void(tlsf_replay_result &, uint64_t, size_t)> & sample)
+{
+  struct live_block
+  {
+    void * ptr;
+    size_t size;
+    size_t alignment;
+  };
+
+  tlsf_replay_result result;
+  atomic_latency_histogram allocate_latency;
+  atomic_latency_histogram deallocate_latency;
+  std::unordered_map<uint64_t, live_block> live;
+  size_t bytes_in_use = 0;
+
+  auto release = [&](const live_block & block) {
+      auto start = std::chrono::steady_clock::now();
+      resource.deallocate(block.ptr, block.size, block.alignment);
+      deallocate_latency.record(
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count()));
+      bytes_in_use -= block.size;
+      ++result.deallocation_count;
+    };
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    const tlsf_trace_event & event = events[i];
+    size_t size = static_cast<size_t>(event.size);
+    size_t alignment = std::max<size_t>(event.alignment, 1);
+    switch (event.type) {
+      case tlsf_trace_event::allocate: {
+          // A stale entry means its free was lost; release it to keep the replay balanced.
+          auto stale = live.find(event.address);
+          if (stale != live.end()) {
+            release(stale->second);
+            live.erase(stale);
+          }
+          void * ptr = nullptr;
+          auto start = std::chrono::steady_clock::now();
+          try {
+            ptr = resource.allocate(size, alignment);
+          } catch (const std::bad_alloc &) {
+            ptr = nullptr;
+          }
+          allocate_latency.record(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start).count()));
+          if (ptr == nullptr) {
+            ++result.failed_allocation_count;
+            break;
+          }
+          ++result.allocation_count;
+          live[event.address] = live_block{ptr, size, alignment};
+          bytes_in_use += size;
+          result.peak_bytes_in_use = std::max(result.peak_bytes_in_use, bytes_in_use);
+          break;
+        }
+      case tlsf_trace_event::deallocate: {
+          auto block = live.find(event.address);
+          if (block == live.end()) {
+            ++result.unmatched_deallocation_count;
+            break;
+          }
+          release(block->second);
+          live.erase(block);
+          break;
+        }
+      default:
+        ++result.skipped_failed_allocation_count;
+        break;
+    }
+    if (sample && sample_interval > 0 &&
+      ((i + 1) % sample_interval == 0 || i + 1 == events.size()))
+    {
+      sample(result, i, bytes_in_use);
+    }
+  }
+  for (auto & block : live) {
+    resource.deallocate(block.second.ptr, block.second.size, block.second.alignment);
+  }
+  allocate_latency.snapshot(result.allocate_latency);
+  deallocate_latency.snapshot(result.deallocate_latency);
+  return result;
+}
+
+}  // namespace detail
+}  // namespace tlsf_cpp
+
+/// Replay a trace against an arbitrary memory resource, e.g. std::pmr::new_delete_resource().
+/// Blocks still allocated at the end of the trace are freed afterwards.
+inline tlsf_replay_result tlsf_replay_trace(
+  const std::vector<tlsf_trace_event> & events, std::pmr::memory_resource & resource)
+{
+  return tlsf_cpp::detail::replay_trace(events, resource, 0, nullptr);
+}
+
+/// Replay a trace against a TLSF pool, inspecting its fragmentation every sample_interval
+/// events (0 for never). The pool should be empty; it is left as it was found.
+template<typename LockPolicy>
+tlsf_replay_result tlsf_replay_trace(
+  const std::vector<tlsf_trace_event> & events, basic_tlsf_pool<LockPolicy> & pool,
+  size_t sample_interval = 0)
+{
+  basic_tlsf_memory_resource<LockPolicy> resource(pool);
+  auto sample = [&pool](tlsf_replay_result & result, uint64_t index, size_t bytes_in_use) {
+      tlsf_replay_sample point;
+      point.event_index = index;
+      point.bytes_in_use = bytes_in_use;
+      point.largest_free_block = pool.inspect();
+      point.fragmentation = pool.stats().fragmentation;
+      result.max_fragmentation = std::max(result.max_fragmentation, point.fragmentation);
+      result.timeline.push_back(point);
+    };
+  return tlsf_cpp::detail::replay_trace(events, resource, sample_interval, sample);
+}
+
+/// Smallest TLSF pool size, to within granularity bytes, that replays the trace without a
+/// failed allocation.
+/**
+ * Found by bisection between the peak number of bytes in use and max_size, so it assumes that
+ * a pool that is large enough stays large enough when grown, which holds for TLSF up to a few
+ * bytes of block overhead.
+ * \return The size, or 0 if even a pool of max_size bytes is too small.
+ */
+template<typename LockPolicy = tlsf_no_lock>
+size_t tlsf_find_min_pool_size(
+  const std::vector<tlsf_trace_event> & events, size_t max_size, size_t granularity = 4096)
+{
+  auto fits = [&events](size_t size) {
+      basic_tlsf_pool<LockPolicy> pool(size);
+      return tlsf_replay_trace(events, pool).failed_allocation_count == 0;
+    };
+  if (!fits(max_size)) {
+    return 0;
+  }
+  // No pool smaller than the peak demand can fit, whatever its overhead.
+  size_t low = tlsf_replay_trace(events, *std::pmr::new_delete_resource()).peak_bytes_in_use;
+  size_t high = max_size;
+  while (high - low > granularity) {
+    size_t mid = low + (high - low) / 2;
+    if (fits(mid)) {
+      high = mid;
+    } else {
+      low = mid;
+    }
+  }
+  return high;
+}
+
+#endif  // TLSF_CPP__TLSF_TRACE_REPLAY_HPP_
@@ -0,0 +1,563 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replacement for the glibc allocator and the global operator new/delete backed by one TLSF
+// pool. See tlsf_cpp/global_allocator.h for the configuration.
+//
+// Nothing in here may allocate through malloc before the pool is ready, which is why the pool
+// lives in an anonymous mapping and the environment is parsed by hand.
+
+#include "tlsf_cpp/global_allocator.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "tlsf/tlsf.h"
+#include "tlsf_cpp/tlsf_allocator_hooks.hpp"
+
+extern "C"
+{
+// The glibc allocator under its internal names, used when the pool is exhausted.
+void * __libc_malloc(size_t size);
+void __libc_free(void * ptr);
+}
+
+namespace
+{
+
+// Every block, from the pool or the fallback allocator, is preceded by this header so that
+// free, realloc and malloc_usable_size work without asking the allocator for the block size.
+struct block_header
+{
+  size_t size;
+  size_t offset;
+};
+
+constexpr size_t header_size = sizeof(block_header);
+constexpr size_t default_alignment = alignof(std::max_align_t);
+// Alignment guaranteed by both TLSF and glibc for the raw block.
+constexpr size_t raw_alignment = alignof(void *);
+constexpr size_t default_pool_size = 64 * 1024 * 1024;
+
+enum pool_state : int
+{
+  uninitialized = 0,
+  initializing,
+  ready,
+  unavailable
+};
+
+struct global_pool
+{
+  char * memory;
+  size_t size;
+  int locked;
+  pthread_mutex_t mutex;
+  std::atomic<int> state;
+
+  std::atomic<uint64_t> pool_allocations;
+  std::atomic<uint64_t> pool_deallocations;
+  size_t pool_bytes_in_use;
+  size_t pool_peak_bytes_in_use;
+  std::atomic<uint64_t> fallback_allocations;
+  std::atomic<uint64_t> fallback_deallocations;
+  std::atomic<size_t> fallback_bytes;
+};
+
+// Zero-initialized before any constructor runs, so it is usable from the first malloc call.
+global_pool g_pool;
+
+// Parse a size in bytes with an optional b, kb, mb or gb suffix, like
+// tlsf_cpp::detail::parse_size but without allocating. Anything else, including sizes that do
+// not fit in size_t, gives default_value.
+size_t parse_size(const char * input, size_t default_value)
+{
+  if (input == nullptr || *input < '0' || *input > '9') {
+    return default_value;
+  }
+  constexpr size_t max_size = std::numeric_limits<size_t>::max();
+  size_t value = 0;
+  const char * c = input;
+  for (; *c >= '0' && *c <= '9'; ++c) {
+    size_t digit = static_cast<size_t>(*c - '0');
+    if (value > (max_size - digit) / 10) {
+      return default_value;
+    }
+    value = value * 10 + digit;
+  }
+  unsigned shift;
+  if (*c == '\0' || strcmp(c, "b") == 0) {
+    shift = 0;
+  } else if (strcmp(c, "kb") == 0) {
+    shift = 10;
+  } else if (strcmp(c, "mb") == 0) {
+    shift = 20;
+  } else if (strcmp(c, "gb") == 0) {
+    shift = 30;
+  } else {
+    return default_value;
+  }
+  if (value > (max_size >> shift)) {
+    return default_value;
+  }
+  return value << shift;
+}
+
+void initialize_mutex()
+{
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+  pthread_mutex_init(&g_pool.mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+// Hold the pool lock across fork, so that the child does not inherit it locked by a thread
+// that does not exist there. The child gets a fresh mutex: the owner of a priority
+// inheritance mutex is a thread ID, which is not the same in the child.
+void lock_before_fork()
+{
+  pthread_mutex_lock(&g_pool.mutex);
+}
+
+void unlock_after_fork_in_parent()
+{
+  pthread_mutex_unlock(&g_pool.mutex);
+}
+
+void reinitialize_after_fork_in_child()
+{
+  initialize_mutex();
+}
+
+bool initialize_pool()
+{
+  size_t size = parse_size(getenv("TLSF_CPP_GLOBAL_POOL_SIZE"), default_pool_size);
+  const char * lock_env = getenv("TLSF_CPP_GLOBAL_POOL_LOCK");
+  bool lock = lock_env == nullptr || strcmp(lock_env, "0") != 0;
+
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (lock) {
+    flags |= MAP_POPULATE;
+  }
+  void * memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (memory == MAP_FAILED) {
+    return false;
+  }
+  if (lock && mlock(memory, size) == 0) {
+    g_pool.locked = 1;
+  }
+  size_t capacity = init_memory_pool(size, memory);
+  if (capacity == 0 || capacity == static_cast<size_t>(-1)) {
+    munmap(memory, size);
+    return false;
+  }
+
+  initialize_mutex();
+
+  g_pool.memory = static_cast<char *>(memory);
+  g_pool.size = size;
+  return true;
+}
+
+bool pool_ready()
+{
+  int state = g_pool.state.load(std::memory_order_acquire);
+  if (state == ready) {
+    return true;
+  }
+  if (state == unavailable) {
+    return false;
+  }
+  int expected = uninitialized;
+  if (g_pool.state.compare_exchange_strong(expected, initializing, std::memory_order_acq_rel)) {
+    state = initialize_pool() ? ready : unavailable;
+    g_pool.state.store(state, std::memory_order_release);
+    if (state == ready) {
+      // Only once the pool is ready: pthread_atfork may allocate.
+      pthread_atfork(
+        lock_before_fork, unlock_after_fork_in_parent, reinitialize_after_fork_in_child);
+    }
+    return state == ready;
+  }
+  while ((state = g_pool.state.load(std::memory_order_acquire)) == initializing) {
+    sched_yield();
+  }
+  return state == ready;
+}
+
+bool in_pool(const void * ptr)
+{
+  auto p = static_cast<const char *>(ptr);
+  return g_pool.memory != nullptr && p >= g_pool.memory && p < g_pool.memory + g_pool.size;
+}
+
+block_header * header_of(void * ptr)
+{
+  return static_cast<block_header *>(ptr) - 1;
+}
+
+void * allocate_block(size_t size, size_t alignment)
+{
+  if (alignment < default_alignment) {
+    alignment = default_alignment;
+  }
+  if (size > std::numeric_limits<size_t>::max() - header_size - alignment) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  size_t total = size + header_size + alignment - raw_alignment;
+
+  void * raw = nullptr;
+  bool from_pool = false;
+  if (pool_ready()) {
+    pthread_mutex_lock(&g_pool.mutex);
+    raw = malloc_ex(total, g_pool.memory);
+    if (raw != nullptr) {
+      g_pool.pool_bytes_in_use += size;
+      if (g_pool.pool_bytes_in_use > g_pool.pool_peak_bytes_in_use) {
+        g_pool.pool_peak_bytes_in_use = g_pool.pool_bytes_in_use;
+      }
+    }
+    pthread_mutex_unlock(&g_pool.mutex);
+    from_pool = raw != nullptr;
+  }
+  if (from_pool) {
+    g_pool.pool_allocations.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    raw = __libc_malloc(total);
+    if (raw == nullptr) {
+      errno = ENOMEM;
+      return nullptr;
+    }
+    g_pool.fallback_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_pool.fallback_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  uintptr_t user = (reinterpret_cast<uintptr_t>(raw) + header_size + alignment - 1) &
+    ~(alignment - 1);
+  block_header * header = reinterpret_cast<block_header *>(user) - 1;
+  header->size = size;
+  header->offset = user - reinterpret_cast<uintptr_t>(raw);
+  return reinterpret_cast<void *>(user);
+}
+
+void free_block(void * ptr)
+{
+  block_header * header = header_of(ptr);
+  char * raw = static_cast<char *>(ptr) - header->offset;
+  size_t size = header->size;
+  if (in_pool(raw)) {
+    pthread_mutex_lock(&g_pool.mutex);
+    free_ex(raw, g_pool.memory);
+    g_pool.pool_bytes_in_use -= size;
+    pthread_mutex_unlock(&g_pool.mutex);
+    g_pool.pool_deallocations.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    __libc_free(raw);
+    g_pool.fallback_deallocations.fetch_add(1, std::memory_order_relaxed);
+    g_pool.fallback_bytes.fetch_sub(size, std::memory_order_relaxed);
+  }
+}
+
+// Every allocation and deallocation, from the pool or the fallback, is reported to rttest when
+// it is linked into the process.
+void * allocate(size_t size, size_t alignment)
+{
+  return tlsf_cpp::detail::report_allocation(
+    1, size, [&]() {return allocate_block(size, alignment);});
+}
+
+void deallocate(void * ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  tlsf_cpp::detail::report_deallocation(1, [&]() {free_block(ptr);});
+}
+
+void * reallocate(void * ptr, size_t size)
+{
+  if (ptr == nullptr) {
+    return allocate(size, default_alignment);
+  }
+  if (size == 0) {
+    deallocate(ptr);
+    return nullptr;
+  }
+  size_t old_size = header_of(ptr)->size;
+  // Keep the block if it is big enough and would not waste more than half of it.
+  if (size <= old_size && size >= old_size / 2) {
+    return ptr;
+  }
+  void * new_ptr = allocate(size, default_alignment);
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  memcpy(new_ptr, ptr, size < old_size ? size : old_size);
+  deallocate(ptr);
+  return new_ptr;
+}
+
+void * operator_new(size_t size, size_t alignment)
+{
+  if (size == 0) {
+    size = 1;
+  }
+  for (;;) {
+    void * ptr = allocate(size, alignment);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void * operator_new_nothrow(size_t size, size_t alignment) noexcept
+{
+  try {
+    return operator_new(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+}  // namespace
+
+extern "C"
+{
+
+void * malloc(size_t size)
+{
+  return allocate(size, default_alignment);
+}
+
+void free(void * ptr)
+{
+  deallocate(ptr);
+}
+
+void * calloc(size_t count, size_t size)
+{
+  if (size != 0 && count > std::numeric_limits<size_t>::max() / size) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  void * ptr = allocate(count * size, default_alignment);
+  if (ptr != nullptr) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void * realloc(void * ptr, size_t size)
+{
+  return reallocate(ptr, size);
+}
+
+void * memalign(size_t alignment, size_t size)
+{
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  return allocate(size, alignment);
+}
+
+int posix_memalign(void ** result, size_t alignment, size_t size)
+{
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  void * ptr = allocate(size, alignment);
+  if (ptr == nullptr) {
+    return ENOMEM;
+  }
+  *result = ptr;
+  return 0;
+}
+
+void * aligned_alloc(size_t alignment, size_t size)
+{
+  return memalign(alignment, size);
+}
+
+void * valloc(size_t size)
+{
+  return allocate(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+}
+
+void * pvalloc(size_t size)
+{
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return allocate((size + page_size - 1) & ~(page_size - 1), page_size);
+}
+
+size_t malloc_usable_size(void * ptr)
+{
+  return ptr == nullptr ? 0 : header_of(ptr)->size;
+}
+
+int tlsf_global_get_stats(struct tlsf_global_stats * stats)
+{
+  if (stats == nullptr) {
+    return -1;
+  }
+  pool_ready();
+  stats->pool_size = g_pool.size;
+  stats->pool_locked = g_pool.locked;
+  stats->pool_allocations = g_pool.pool_allocations.load(std::memory_order_relaxed);
+  stats->pool_deallocations = g_pool.pool_deallocations.load(std::memory_order_relaxed);
+  if (g_pool.state.load(std::memory_order_acquire) == ready) {
+    pthread_mutex_lock(&g_pool.mutex);
+    stats->pool_bytes_in_use = g_pool.pool_bytes_in_use;
+    stats->pool_peak_bytes_in_use = g_pool.pool_peak_bytes_in_use;
+    pthread_mutex_unlock(&g_pool.mutex);
+  } else {
+    stats->pool_bytes_in_use = 0;
+    stats->pool_peak_bytes_in_use = 0;
+  }
+  stats->fallback_allocations = g_pool.fallback_allocations.load(std::memory_order_relaxed);
+  stats->fallback_deallocations = g_pool.fallback_deallocations.load(std::memory_order_relaxed);
+  stats->fallback_bytes = g_pool.fallback_bytes.load(std::memory_order_relaxed);
+  return 0;
+}
+
+int tlsf_global_owns(const void * ptr)
+{
+  if (ptr == nullptr) {
+    return 0;
+  }
+  auto header = static_cast<const block_header *>(ptr) - 1;
+  return in_pool(static_cast<const char *>(ptr) - header->offset) ? 1 : 0;
+}
+
+}  // extern "C"
+
+void * operator new(std::size_t size)
+{
+  return operator_new(size, default_alignment);
+}
+
+void * operator new[](std::size_t size)
+{
+  return operator_new(size, default_alignment);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return operator_new_nothrow(size, default_alignment);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  return operator_new_nothrow(size, default_alignment);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+  return operator_new(size, static_cast<size_t>(alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return operator_new(size, static_cast<size_t>(alignment));
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return operator_new_nothrow(size, static_cast<size_t>(alignment));
+}
+
+void * operator new[](
+  std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return operator_new_nothrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void * ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
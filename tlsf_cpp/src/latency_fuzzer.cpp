@@ -0,0 +1,416 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Search for allocation and free sequences that make a TLSF pool slow or fragmented.
+//
+// Fixed benchmark patterns rarely reach the slow paths of TLSF, such as splitting a block
+// found several bitmap levels up or merging with both neighbours. This tool mutates sequences
+// of allocations and frees, replays each one against a fresh pool and keeps those with the
+// worst operation latency or fragmentation as parents for further mutations. Sizes are
+// biased towards the boundaries of the TLSF size classes.
+//
+// A latency only counts if it reproduces: every sequence is replayed several times and scored
+// by the smallest of its worst operation latencies, so that a single interrupt does not
+// steer the search.
+//
+// The worst sequences are written to the output directory in the format of
+// tlsf_trace_recorder, as worst_latency.trace and worst_fragmentation.trace, along with the
+// final population as corpus_<n>.trace. Pass them back with -c to resume a search or keep
+// them as regression inputs, and replay them with tlsf_trace_replay.
+//
+// Usage: tlsf_latency_fuzzer [-n iterations] [-s pool_size] [-l max_length] [-r repeats]
+//                            [-p population] [-S seed] [-o output_dir] [-c trace_file]...
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_registry.hpp"
+#include "tlsf_cpp/tlsf_trace.hpp"
+#include "tlsf_cpp/tlsf_trace_replay.hpp"
+
+namespace
+{
+
+// One step of a sequence. Frees name a live block by position, modulo the number of live
+// blocks, so that every mutation of a sequence is still a valid sequence.
+struct fuzz_op
+{
+  bool allocate;
+  uint32_t value;
+};
+
+struct candidate
+{
+  std::vector<fuzz_op> ops;
+  uint64_t latency_ns = 0;
+  double fragmentation = 0.0;
+};
+
+struct fuzz_options
+{
+  size_t iterations = 10000;
+  size_t pool_size = 1024 * 1024;
+  size_t max_length = 2000;
+  size_t repeats = 3;
+  size_t population = 32;
+  uint64_t seed = 1;
+  std::string output_dir = ".";
+  std::vector<std::string> seed_files;
+};
+
+std::vector<tlsf_trace_event> to_trace(const std::vector<fuzz_op> & ops)
+{
+  std::vector<tlsf_trace_event> events;
+  std::vector<uint64_t> live;
+  uint64_t next_address = 0;
+  for (const auto & op : ops) {
+    tlsf_trace_event event{};
+    event.timestamp_ns = events.size();
+    event.alignment = 1;
+    if (op.allocate) {
+      // Addresses only need to tell blocks apart in a replay.
+      next_address += 64;
+      event.type = tlsf_trace_event::allocate;
+      event.address = next_address;
+      event.size = std::max<uint32_t>(op.value, 1);
+      live.push_back(next_address);
+    } else {
+      if (live.empty()) {
+        continue;
+      }
+      size_t index = op.value % live.size();
+      event.type = tlsf_trace_event::deallocate;
+      event.address = live[index];
+      live[index] = live.back();
+      live.pop_back();
+    }
+    events.push_back(event);
+  }
+  return events;
+}
+
+// The inverse of to_trace(), for seed traces; failed allocations and unmatched frees are
+// dropped.
+std::vector<fuzz_op> from_trace(const std::vector<tlsf_trace_event> & events)
+{
+  std::vector<fuzz_op> ops;
+  std::vector<uint64_t> live;
+  for (const auto & event : events) {
+    if (event.type == tlsf_trace_event::allocate) {
+      ops.push_back({true, static_cast<uint32_t>(std::min<uint64_t>(event.size, UINT32_MAX))});
+      live.push_back(event.address);
+    } else if (event.type == tlsf_trace_event::deallocate) {
+      auto block = std::find(live.begin(), live.end(), event.address);
+      if (block == live.end()) {
+        continue;
+      }
+      size_t index = static_cast<size_t>(block - live.begin());
+      ops.push_back({false, static_cast<uint32_t>(index)});
+      *block = live.back();
+      live.pop_back();
+    }
+  }
+  return ops;
+}
+
+class fuzzer
+{
+public:
+  explicit fuzzer(const fuzz_options & options)
+  : options_(options), random_(options.seed)
+  {
+  }
+
+  void evaluate(candidate & c)
+  {
+    auto events = to_trace(c.ops);
+    size_t sample_interval = std::max<size_t>(events.size() / 64, 1);
+    c.latency_ns = UINT64_MAX;
+    c.fragmentation = 0.0;
+    for (size_t repeat = 0; repeat < options_.repeats; ++repeat) {
+      tlsf_pool pool(options_.pool_size);
+      auto result = tlsf_replay_trace(events, pool, sample_interval);
+      c.latency_ns = std::min(
+        c.latency_ns,
+        std::max(result.allocate_latency.max_ns, result.deallocate_latency.max_ns));
+      c.fragmentation = std::max(c.fragmentation, result.max_fragmentation);
+    }
+  }
+
+  uint32_t random_size()
+  {
+    // Just around a class boundary 2^k + j * 2^(k - 5), the second level of TLSF 2.4.6 being
+    // 32 classes wide, or anywhere up to a quarter of the pool.
+    size_t limit = std::max<size_t>(options_.pool_size / 4, 16);
+    if (pick(4) != 0) {
+      size_t max_log2 = 63 - static_cast<size_t>(__builtin_clzll(limit));
+      size_t log2 = 4 + pick(max_log2 - 3);
+      size_t size = (size_t(1) << log2) + pick(32) * (size_t(1) << (log2 > 5 ? log2 - 5 : 0));
+      size = size + pick(33) - 16;
+      return static_cast<uint32_t>(std::clamp<size_t>(size, 1, limit));
+    }
+    return static_cast<uint32_t>(1 + pick(limit));
+  }
+
+  fuzz_op random_op()
+  {
+    if (pick(2) == 0) {
+      return {true, random_size()};
+    }
+    return {false, static_cast<uint32_t>(random_())};
+  }
+
+  std::vector<fuzz_op> generate()
+  {
+    std::vector<fuzz_op> ops(1 + pick(std::min<size_t>(options_.max_length, 200)));
+    for (auto & op : ops) {
+      op = random_op();
+    }
+    return ops;
+  }
+
+  std::vector<fuzz_op> mutate(const std::vector<fuzz_op> & parent)
+  {
+    std::vector<fuzz_op> ops = parent;
+    size_t mutations = 1 + pick(4);
+    for (size_t m = 0; m < mutations; ++m) {
+      if (ops.empty()) {
+        ops.push_back(random_op());
+        continue;
+      }
+      size_t at = pick(ops.size());
+      switch (pick(7)) {
+        case 0:
+          ops.insert(ops.begin() + static_cast<std::ptrdiff_t>(at), random_op());
+          break;
+        case 1:
+          ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(at));
+          break;
+        case 2:
+          ops[at] = random_op();
+          break;
+        case 3:
+          // Nudge a size across the neighbouring class boundaries.
+          if (ops[at].allocate) {
+            int64_t delta = static_cast<int64_t>(pick(257)) - 128;
+            ops[at].value = static_cast<uint32_t>(
+              std::max<int64_t>(1, static_cast<int64_t>(ops[at].value) + delta));
+          } else {
+            ops[at].value = static_cast<uint32_t>(random_());
+          }
+          break;
+        case 4: {
+            // Repeat a stretch, which builds up the patterns that fragment the pool.
+            size_t length = 1 + pick(std::min<size_t>(ops.size() - at, 64));
+            std::vector<fuzz_op> stretch(
+              ops.begin() + static_cast<std::ptrdiff_t>(at),
+              ops.begin() + static_cast<std::ptrdiff_t>(at + length));
+            ops.insert(ops.end(), stretch.begin(), stretch.end());
+            break;
+          }
+        case 5: {
+            // Splice in the tail of another member of the population.
+            const auto & other = population_[pick(population_.size())].ops;
+            if (!other.empty()) {
+              size_t from = pick(other.size());
+              ops.resize(at);
+              ops.insert(
+                ops.end(), other.begin() + static_cast<std::ptrdiff_t>(from), other.end());
+            }
+            break;
+          }
+        default:
+          std::swap(ops[at], ops[pick(ops.size())]);
+          break;
+      }
+    }
+    if (ops.size() > options_.max_length) {
+      ops.resize(options_.max_length);
+    }
+    return ops;
+  }
+
+  // Keep the better half of the population by latency and the better half by fragmentation.
+  void select()
+  {
+    size_t half = std::max<size_t>(options_.population / 2, 1);
+    std::sort(
+      population_.begin(), population_.end(), [](const candidate & a, const candidate & b) {
+        return a.latency_ns > b.latency_ns;
+      });
+    std::vector<candidate> kept(
+      population_.begin(),
+      population_.begin() + static_cast<std::ptrdiff_t>(std::min(half, population_.size())));
+    std::vector<candidate> rest(
+      population_.begin() + static_cast<std::ptrdiff_t>(kept.size()), population_.end());
+    std::sort(
+      rest.begin(), rest.end(), [](const candidate & a, const candidate & b) {
+        return a.fragmentation > b.fragmentation;
+      });
+    for (size_t i = 0; i < rest.size() && kept.size() < options_.population; ++i) {
+      kept.push_back(rest[i]);
+    }
+    population_ = std::move(kept);
+  }
+
+  bool save(const std::vector<fuzz_op> & ops, const std::string & name) const
+  {
+    std::ofstream out(options_.output_dir + "/" + name);
+    if (!out) {
+      fprintf(stderr, "Could not write %s/%s\n", options_.output_dir.c_str(), name.c_str());
+      return false;
+    }
+    tlsf_write_trace(out, to_trace(ops));
+    return true;
+  }
+
+  void record(const candidate & c, size_t iteration)
+  {
+    if (c.latency_ns > worst_latency_.latency_ns) {
+      worst_latency_ = c;
+      printf(
+        "%10zu  worst latency %10llu ns  (%zu ops)\n", iteration,
+        static_cast<unsigned long long>(c.latency_ns), c.ops.size());  // NOLINT(runtime/int)
+      save(c.ops, "worst_latency.trace");
+    }
+    if (c.fragmentation > worst_fragmentation_.fragmentation) {
+      worst_fragmentation_ = c;
+      printf(
+        "%10zu  worst fragmentation %8.3f  (%zu ops)\n", iteration, c.fragmentation,
+        c.ops.size());
+      save(c.ops, "worst_fragmentation.trace");
+    }
+  }
+
+  bool run()
+  {
+    for (const auto & filename : options_.seed_files) {
+      std::ifstream in(filename);
+      std::vector<tlsf_trace_event> events;
+      if (!in || !tlsf_read_trace(in, events)) {
+        fprintf(stderr, "Could not read the trace %s\n", filename.c_str());
+        return false;
+      }
+      candidate c;
+      c.ops = from_trace(events);
+      if (c.ops.size() > options_.max_length) {
+        c.ops.resize(options_.max_length);
+      }
+      evaluate(c);
+      printf(
+        "Seed %s: %llu ns, fragmentation %.3f\n", filename.c_str(),
+        static_cast<unsigned long long>(c.latency_ns), c.fragmentation);  // NOLINT(runtime/int)
+      population_.push_back(std::move(c));
+    }
+    while (population_.size() < options_.population) {
+      candidate c;
+      c.ops = generate();
+      evaluate(c);
+      population_.push_back(std::move(c));
+    }
+    for (const auto & c : population_) {
+      record(c, 0);
+    }
+
+    for (size_t iteration = 1; iteration <= options_.iterations; ++iteration) {
+      candidate child;
+      child.ops = mutate(population_[pick(population_.size())].ops);
+      evaluate(child);
+      record(child, iteration);
+      population_.push_back(std::move(child));
+      if (population_.size() >= 2 * options_.population) {
+        select();
+      }
+    }
+    select();
+
+    for (size_t i = 0; i < population_.size(); ++i) {
+      save(population_[i].ops, "corpus_" + std::to_string(i) + ".trace");
+    }
+    printf(
+      "Worst latency %llu ns over %zu ops, worst fragmentation %.3f over %zu ops\n",
+      static_cast<unsigned long long>(worst_latency_.latency_ns),  // NOLINT(runtime/int)
+      worst_latency_.ops.size(), worst_fragmentation_.fragmentation,
+      worst_fragmentation_.ops.size());
+    return true;
+  }
+
+private:
+  size_t pick(size_t bound)
+  {
+    return bound == 0 ? 0 : static_cast<size_t>(random_() % bound);
+  }
+
+  fuzz_options options_;
+  std::mt19937_64 random_;
+  std::vector<candidate> population_;
+  candidate worst_latency_;
+  candidate worst_fragmentation_;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  fuzz_options options;
+  int c;
+  while ((c = getopt(argc, argv, "n:s:l:r:p:S:o:c:")) != -1) {
+    switch (c) {
+      case 'n':
+        options.iterations = std::stoull(optarg);
+        break;
+      case 's':
+        if (!tlsf_cpp::detail::parse_size(optarg, options.pool_size)) {
+          fprintf(stderr, "Invalid pool size: %s\n", optarg);
+          return 1;
+        }
+        break;
+      case 'l':
+        options.max_length = std::max<size_t>(std::stoull(optarg), 1);
+        break;
+      case 'r':
+        options.repeats = std::max<size_t>(std::stoull(optarg), 1);
+        break;
+      case 'p':
+        options.population = std::max<size_t>(std::stoull(optarg), 2);
+        break;
+      case 'S':
+        options.seed = std::stoull(optarg);
+        break;
+      case 'o':
+        options.output_dir = optarg;
+        break;
+      case 'c':
+        options.seed_files.push_back(optarg);
+        break;
+      default:
+        fprintf(
+          stderr, "Usage: %s [-n iterations] [-s pool_size] [-l max_length] [-r repeats] "
+          "[-p population] [-S seed] [-o output_dir] [-c trace_file]...\n", argv[0]);
+        return 1;
+    }
+  }
+
+  fuzzer search(options);
+  return search.run() ? 0 : 1;
+}
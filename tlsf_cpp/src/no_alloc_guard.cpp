@@ -0,0 +1,196 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replacement for the glibc allocator entry points that checks tlsf_no_alloc_guard before
+// forwarding to glibc. See tlsf_cpp/tlsf_no_alloc_guard.hpp.
+//
+// The guard state lives in initial-exec TLS, which is set up with the thread before any of
+// its code runs, so that reading it from malloc never allocates.
+
+#include "tlsf_cpp/tlsf_no_alloc_guard.hpp"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+// The glibc allocator under its internal names.
+void * __libc_malloc(size_t size);
+void __libc_free(void * ptr);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * ptr, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+void * __libc_valloc(size_t size);
+void * __libc_pvalloc(size_t size);
+}
+
+namespace
+{
+
+struct guard_state
+{
+  bool active;
+  // Set while a call is being reported, so that the report itself is never reported.
+  bool reporting;
+  tlsf_no_alloc_guard::action_type action;
+  uint64_t allocations;
+  uint64_t deallocations;
+};
+
+thread_local guard_state state __attribute__((tls_model("initial-exec")));
+
+// Print the call, formatted into a local buffer: stdio would allocate to buffer it.
+void report(const char * function, size_t size, const void * ptr)
+{
+  state.reporting = true;
+  char message[160];
+  int length;
+  if (ptr != nullptr) {
+    length = snprintf(
+      message, sizeof(message), "tlsf_no_alloc_guard: %s(%p) called in a guarded section\n",
+      function, ptr);
+  } else {
+    length = snprintf(
+      message, sizeof(message), "tlsf_no_alloc_guard: %s(%zu) called in a guarded section\n",
+      function, size);
+  }
+  if (length > 0) {
+    ssize_t written = write(
+      STDERR_FILENO, message, static_cast<size_t>(length) < sizeof(message) ?
+      static_cast<size_t>(length) : sizeof(message) - 1);
+    (void)written;
+  }
+  if (state.action == tlsf_no_alloc_guard::abort_on_call) {
+    abort();
+  }
+  state.reporting = false;
+}
+
+inline void on_allocation(const char * function, size_t size)
+{
+  if (state.active && !state.reporting) {
+    ++state.allocations;
+    if (state.action != tlsf_no_alloc_guard::count_calls) {
+      report(function, size, nullptr);
+    }
+  }
+}
+
+inline void on_deallocation(void * ptr)
+{
+  if (ptr != nullptr && state.active && !state.reporting) {
+    ++state.deallocations;
+    if (state.action != tlsf_no_alloc_guard::count_calls) {
+      report("free", 0, ptr);
+    }
+  }
+}
+
+}  // namespace
+
+tlsf_no_alloc_guard::tlsf_no_alloc_guard(action_type action) noexcept
+: previous_active_(state.active), previous_action_(state.action),
+  allocations_at_start_(state.allocations), deallocations_at_start_(state.deallocations)
+{
+  state.action = action;
+  state.active = true;
+}
+
+tlsf_no_alloc_guard::~tlsf_no_alloc_guard()
+{
+  state.active = previous_active_;
+  state.action = previous_action_;
+}
+
+uint64_t tlsf_no_alloc_guard::allocations() const noexcept
+{
+  return state.allocations - allocations_at_start_;
+}
+
+uint64_t tlsf_no_alloc_guard::deallocations() const noexcept
+{
+  return state.deallocations - deallocations_at_start_;
+}
+
+extern "C"
+{
+
+void * malloc(size_t size)
+{
+  on_allocation("malloc", size);
+  return __libc_malloc(size);
+}
+
+void free(void * ptr)
+{
+  on_deallocation(ptr);
+  __libc_free(ptr);
+}
+
+void * calloc(size_t count, size_t size)
+{
+  on_allocation("calloc", count * size);
+  return __libc_calloc(count, size);
+}
+
+void * realloc(void * ptr, size_t size)
+{
+  on_allocation("realloc", size);
+  return __libc_realloc(ptr, size);
+}
+
+void * memalign(size_t alignment, size_t size)
+{
+  on_allocation("memalign", size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void ** result, size_t alignment, size_t size)
+{
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  on_allocation("posix_memalign", size);
+  void * ptr = __libc_memalign(alignment, size);
+  if (ptr == nullptr) {
+    return ENOMEM;
+  }
+  *result = ptr;
+  return 0;
+}
+
+void * aligned_alloc(size_t alignment, size_t size)
+{
+  on_allocation("aligned_alloc", size);
+  return __libc_memalign(alignment, size);
+}
+
+void * valloc(size_t size)
+{
+  on_allocation("valloc", size);
+  return __libc_valloc(size);
+}
+
+void * pvalloc(size_t size)
+{
+  on_allocation("pvalloc", size);
+  return __libc_pvalloc(size);
+}
+
+}  // extern "C"
@@ -0,0 +1,161 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replay an allocation trace recorded with tlsf_trace_recorder against TLSF pools of several
+// sizes and against the standard allocators, and report how each one coped.
+//
+// Usage: tlsf_trace_replay [-s pool_size]... [-m max_pool_size] [-i sample_interval]
+//                          [-t timeline_file] trace_file
+//
+// Without -s, the pool is sized from the trace: the smallest pool that replays it without a
+// failed allocation is searched for, and replayed along with pools of 1.5 and 2 times its size.
+
+#include <getopt.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_registry.hpp"
+#include "tlsf_cpp/tlsf_trace.hpp"
+#include "tlsf_cpp/tlsf_trace_replay.hpp"
+
+namespace
+{
+
+void print_header()
+{
+  printf(
+    "%-28s %12s %8s %12s %8s %10s %10s %10s %10s\n", "allocator", "pool_size", "failed",
+    "peak_in_use", "max_frag", "alloc_p99", "alloc_max", "free_p99", "free_max");
+}
+
+void print_result(const char * name, size_t pool_size, const tlsf_replay_result & result)
+{
+  printf(
+    "%-28s %12zu %8llu %12zu %8.3f %10llu %10llu %10llu %10llu\n", name, pool_size,
+    static_cast<unsigned long long>(result.failed_allocation_count),  // NOLINT(runtime/int)
+    result.peak_bytes_in_use, result.max_fragmentation,
+    static_cast<unsigned long long>(  // NOLINT(runtime/int)
+      result.allocate_latency.percentile_upper_bound_ns(0.99)),
+    static_cast<unsigned long long>(result.allocate_latency.max_ns),  // NOLINT(runtime/int)
+    static_cast<unsigned long long>(  // NOLINT(runtime/int)
+      result.deallocate_latency.percentile_upper_bound_ns(0.99)),
+    static_cast<unsigned long long>(result.deallocate_latency.max_ns));  // NOLINT(runtime/int)
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  std::vector<size_t> pool_sizes;
+  size_t max_pool_size = size_t(1) << 30;
+  size_t sample_interval = 1000;
+  std::string timeline_filename;
+
+  int c;
+  while ((c = getopt(argc, argv, "s:m:i:t:")) != -1) {
+    switch (c) {
+      case 's':
+        {
+          size_t pool_size;
+          if (!tlsf_cpp::detail::parse_size(optarg, pool_size)) {
+            fprintf(stderr, "Invalid pool size: %s\n", optarg);
+            return 1;
+          }
+          pool_sizes.push_back(pool_size);
+          break;
+        }
+      case 'm':
+        if (!tlsf_cpp::detail::parse_size(optarg, max_pool_size)) {
+          fprintf(stderr, "Invalid pool size: %s\n", optarg);
+          return 1;
+        }
+        break;
+      case 'i':
+        sample_interval = std::stoull(optarg);
+        break;
+      case 't':
+        timeline_filename = optarg;
+        break;
+      default:
+        fprintf(
+          stderr, "Usage: %s [-s pool_size]... [-m max_pool_size] [-i sample_interval] "
+          "[-t timeline_file] trace_file\n", argv[0]);
+        return 1;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "Expected a single trace file\n");
+    return 1;
+  }
+
+  std::vector<tlsf_trace_event> events;
+  std::ifstream trace_file(argv[optind]);
+  if (!trace_file) {
+    fprintf(stderr, "Could not open %s\n", argv[optind]);
+    return 1;
+  }
+  if (!tlsf_read_trace(trace_file, events)) {
+    fprintf(stderr, "Malformed trace after %zu events\n", events.size());
+    return 1;
+  }
+  printf("Read %zu events from %s\n", events.size(), argv[optind]);
+
+  if (pool_sizes.empty()) {
+    size_t min_size = tlsf_find_min_pool_size(events, max_pool_size);
+    if (min_size == 0) {
+      fprintf(stderr, "The trace does not fit in a pool of %zu bytes\n", max_pool_size);
+      pool_sizes.push_back(max_pool_size);
+    } else {
+      printf("Smallest pool without failed allocations: %zu bytes\n", min_size);
+      pool_sizes = {min_size, min_size + min_size / 2, 2 * min_size};
+    }
+  }
+
+  std::ofstream timeline;
+  if (!timeline_filename.empty()) {
+    timeline.open(timeline_filename);
+    timeline << "pool_size event bytes_in_use largest_free_block fragmentation\n";
+  }
+
+  print_header();
+  for (size_t pool_size : pool_sizes) {
+    tlsf_pool pool(pool_size);
+    auto result = tlsf_replay_trace(events, pool, sample_interval);
+    print_result("tlsf", pool_size, result);
+    if (timeline.is_open()) {
+      for (const auto & sample : result.timeline) {
+        timeline << pool_size << " " << sample.event_index << " " << sample.bytes_in_use << " " <<
+          sample.largest_free_block << " " << sample.fragmentation << "\n";
+      }
+    }
+  }
+
+  print_result(
+    "malloc", 0, tlsf_replay_trace(events, *std::pmr::new_delete_resource()));
+  {
+    std::pmr::unsynchronized_pool_resource resource;
+    print_result("pmr::unsynchronized_pool", 0, tlsf_replay_trace(events, resource));
+  }
+  {
+    std::pmr::monotonic_buffer_resource resource;
+    print_result("pmr::monotonic_buffer", 0, tlsf_replay_trace(events, resource));
+  }
+  return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tlsf_cpp/global_allocator.h"
+
+// This test runs with TLSF_CPP_GLOBAL_POOL_SIZE=8mb, see CMakeLists.txt.
+
+TEST(TLSFGlobalAllocator, malloc_and_new_use_pool)
+{
+  struct tlsf_global_stats before;
+  ASSERT_EQ(0, tlsf_global_get_stats(&before));
+  EXPECT_EQ(8u * 1024u * 1024u, before.pool_size);
+
+  void * block = malloc(100);
+  EXPECT_EQ(1, tlsf_global_owns(block));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t));
+  EXPECT_GE(malloc_usable_size(block), 100u);
+  free(block);
+
+  auto object = std::make_unique<std::string>("not a short string, so it allocates its buffer");
+  EXPECT_EQ(1, tlsf_global_owns(object.get()));
+  EXPECT_EQ(1, tlsf_global_owns(object->data()));
+  object.reset();
+
+  struct tlsf_global_stats after;
+  ASSERT_EQ(0, tlsf_global_get_stats(&after));
+  EXPECT_GE(after.pool_allocations, before.pool_allocations + 3);
+  EXPECT_GE(after.pool_deallocations, before.pool_deallocations + 3);
+  EXPECT_EQ(-1, tlsf_global_get_stats(nullptr));
+}
+
+TEST(TLSFGlobalAllocator, alignment_and_realloc)
+{
+  for (size_t alignment : {16u, 64u, 256u, 4096u}) {
+    void * block = nullptr;
+    ASSERT_EQ(0, posix_memalign(&block, alignment, 24));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % alignment);
+    EXPECT_EQ(1, tlsf_global_owns(block));
+    free(block);
+  }
+  void * misaligned = nullptr;
+  EXPECT_NE(0, posix_memalign(&misaligned, 24, 8));
+
+  auto bytes = static_cast<unsigned char *>(malloc(16));
+  for (unsigned char i = 0; i < 16; ++i) {
+    bytes[i] = i;
+  }
+  bytes = static_cast<unsigned char *>(realloc(bytes, 4096));
+  ASSERT_NE(nullptr, bytes);
+  for (unsigned char i = 0; i < 16; ++i) {
+    EXPECT_EQ(i, bytes[i]);
+  }
+  free(bytes);
+
+  auto zeros = static_cast<uint64_t *>(calloc(128, sizeof(uint64_t)));
+  for (size_t i = 0; i < 128; ++i) {
+    EXPECT_EQ(0u, zeros[i]);
+  }
+  free(zeros);
+}
+
+TEST(TLSFGlobalAllocator, fallback_when_exhausted)
+{
+  struct tlsf_global_stats before;
+  tlsf_global_get_stats(&before);
+
+  void * huge = malloc(16 * 1024 * 1024);
+  ASSERT_NE(nullptr, huge);
+  EXPECT_EQ(0, tlsf_global_owns(huge));
+  memset(huge, 0, 16 * 1024 * 1024);
+
+  struct tlsf_global_stats during;
+  tlsf_global_get_stats(&during);
+  EXPECT_EQ(before.fallback_allocations + 1, during.fallback_allocations);
+  EXPECT_GE(during.fallback_bytes, 16u * 1024u * 1024u);
+
+  free(huge);
+  struct tlsf_global_stats after;
+  tlsf_global_get_stats(&after);
+  EXPECT_EQ(before.fallback_deallocations + 1, after.fallback_deallocations);
+  EXPECT_EQ(before.fallback_bytes, after.fallback_bytes);
+}
+
+TEST(TLSFGlobalAllocator, concurrent_threads)
+{
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back(
+      []() {
+        std::vector<std::unique_ptr<char[]>> blocks;
+        for (size_t i = 0; i < 10000; ++i) {
+          blocks.emplace_back(new char[(i % 64) + 1]);
+          if (blocks.size() > 32) {
+            blocks.erase(blocks.begin());
+          }
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  struct tlsf_global_stats stats;
+  tlsf_global_get_stats(&stats);
+  EXPECT_LT(stats.pool_bytes_in_use, stats.pool_size);
+}
+
+TEST(TLSFGlobalAllocator, fork_while_other_threads_allocate)
+{
+  std::atomic<bool> done{false};
+  std::thread other([&done]() {
+      while (!done.load()) {
+        free(malloc(64));
+      }
+    });
+  for (int i = 0; i < 50; ++i) {
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+      // Deadlocks if the pool lock was inherited held by the other thread.
+      void * block = malloc(64);
+      free(block);
+      _exit(block != nullptr ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+  }
+  done.store(true);
+  other.join();
+}
@@ -0,0 +1,82 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_memory_resource.hpp"
+
+TEST(TLSFMemoryResource, pmr_containers)
+{
+  tlsf_memory_resource resource(64 * 1024);
+
+  std::pmr::vector<std::pmr::string> strings(&resource);
+  for (size_t i = 0; i < 100; ++i) {
+    strings.emplace_back("a string long enough to defeat the small string optimization");
+  }
+  EXPECT_EQ(100u, strings.size());
+  EXPECT_EQ(&resource, strings.get_allocator().resource());
+  EXPECT_TRUE(resource.pool().contains(strings.data()));
+  EXPECT_TRUE(resource.pool().contains(strings.back().data()));
+}
+
+TEST(TLSFMemoryResource, alignment)
+{
+  tlsf_memory_resource resource(64 * 1024);
+  for (size_t alignment : {1u, 8u, 16u, 64u, 256u, 4096u}) {
+    void * ptr = resource.allocate(24, alignment);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % alignment);
+    resource.deallocate(ptr, 24, alignment);
+  }
+}
+
+TEST(TLSFMemoryResource, exhaustion)
+{
+  tlsf_memory_resource resource(16 * 1024);
+  EXPECT_THROW(static_cast<void>(resource.allocate(32 * 1024)), std::bad_alloc);
+}
+
+TEST(TLSFMemoryResource, is_equal_by_pool)
+{
+  tlsf_heap_allocator<int> alloc(64 * 1024);
+  tlsf_memory_resource borrowed(alloc);
+  tlsf_memory_resource also_borrowed(*alloc.pool);
+  tlsf_memory_resource owned(64 * 1024);
+
+  EXPECT_TRUE(borrowed.is_equal(also_borrowed));
+  EXPECT_FALSE(borrowed.is_equal(owned));
+  EXPECT_FALSE(owned.is_equal(*std::pmr::new_delete_resource()));
+
+  // Memory from one resource may be returned through the other.
+  void * ptr = borrowed.allocate(128);
+  EXPECT_TRUE(alloc.pool->contains(ptr));
+  also_borrowed.deallocate(ptr, 128);
+}
+
+TEST(TLSFMemoryResource, borrowed_pool_outlives_allocator)
+{
+  auto alloc = std::make_unique<tlsf_heap_allocator<int>>(64 * 1024);
+  tlsf_memory_resource resource(*alloc);
+  alloc.reset();
+
+  std::pmr::vector<int> values(&resource);
+  values.assign(1000, 42);
+  EXPECT_EQ(42, values.back());
+}
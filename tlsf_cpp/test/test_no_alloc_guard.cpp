@@ -0,0 +1,102 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_no_alloc_guard.hpp"
+
+// Called through volatile pointers: the compiler removes a malloc paired with its free.
+void * (* volatile heap_malloc)(size_t) = malloc;
+void (* volatile heap_free)(void *) = free;
+
+TEST(TLSFNoAllocGuard, counts_heap_calls)
+{
+  tlsf_no_alloc_guard guard;
+  void * block = heap_malloc(100);
+  heap_free(block);
+  auto object = std::make_unique<std::string>(64, 'x');
+  object.reset();
+  std::vector<int> values(16);
+  values.clear();
+  values.shrink_to_fit();
+  // The string object and its characters are separate allocations.
+  uint64_t allocations = guard.allocations();
+  uint64_t deallocations = guard.deallocations();
+  EXPECT_EQ(4u, allocations);
+  EXPECT_EQ(4u, deallocations);
+}
+
+TEST(TLSFNoAllocGuard, pool_allocations_are_not_heap_calls)
+{
+  tlsf_heap_allocator<int> alloc(64 * 1024);
+  std::vector<int, tlsf_heap_allocator<int>> values(alloc);
+  values.reserve(64);
+
+  tlsf_no_alloc_guard guard;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(i);
+    if (values.size() == 64) {
+      values.clear();
+    }
+  }
+  std::vector<int, tlsf_heap_allocator<int>> copy(values, alloc);
+  EXPECT_EQ(0u, guard.allocations());
+  EXPECT_EQ(0u, guard.deallocations());
+}
+
+TEST(TLSFNoAllocGuard, nesting)
+{
+  tlsf_no_alloc_guard outer;
+  {
+    tlsf_no_alloc_guard inner(tlsf_no_alloc_guard::log_calls);
+    heap_free(heap_malloc(8));
+    EXPECT_EQ(1u, inner.allocations());
+  }
+  heap_free(heap_malloc(8));
+  EXPECT_EQ(2u, outer.allocations());
+  EXPECT_EQ(2u, outer.deallocations());
+}
+
+TEST(TLSFNoAllocGuard, other_threads_are_not_watched)
+{
+  std::atomic<bool> guarded{false};
+  std::thread other([&guarded]() {
+      while (!guarded.load()) {
+        std::this_thread::yield();
+      }
+      heap_free(heap_malloc(8));
+    });
+  tlsf_no_alloc_guard guard;
+  guarded.store(true);
+  other.join();
+  EXPECT_EQ(0u, guard.allocations());
+}
+
+TEST(TLSFNoAllocGuardDeathTest, abort_on_call)
+{
+  EXPECT_DEATH(
+  {
+    tlsf_no_alloc_guard guard(tlsf_no_alloc_guard::abort_on_call);
+    heap_free(heap_malloc(24));
+  }, "malloc\\(24\\) called in a guarded section");
+}
@@ -0,0 +1,149 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_containers.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+namespace rt = tlsf_cpp::rt;
+
+TEST(RTContainers, vector)
+{
+  tlsf_pool pool(64 * 1024);
+  tlsf_heap_allocator<int> alloc(pool);
+  rt::vector<int> values(4, alloc);
+  EXPECT_EQ(4u, values.capacity());
+  size_t reserved = pool.stats().bytes_in_use;
+  EXPECT_GE(reserved, 4 * sizeof(int));
+
+  values.push_back(1);
+  values.emplace_back(2);
+  values.insert(values.begin(), 0);
+  values.resize(4, 3);
+  EXPECT_TRUE(values.full());
+  const int * storage = values.data();
+  EXPECT_THROW(values.push_back(4), std::length_error);
+  EXPECT_THROW(values.insert(values.end(), 2, 4), std::length_error);
+  EXPECT_THROW(values.resize(5), std::length_error);
+  EXPECT_EQ(4u, values.size());
+  EXPECT_EQ(storage, values.data());
+  EXPECT_EQ(reserved, pool.stats().bytes_in_use);
+  EXPECT_EQ(0, values[0]);
+  EXPECT_EQ(3, values.back());
+
+  rt::vector<int> copy(values);
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), copy.begin(), copy.end()));
+  rt::vector<int> small(2, alloc);
+  EXPECT_THROW(small = values, std::length_error);
+  rt::vector<int> moved(std::move(copy));
+  EXPECT_EQ(4u, moved.size());
+  EXPECT_EQ(0u, copy.capacity());
+}
+
+TEST(RTContainers, string)
+{
+  tlsf_pool pool(64 * 1024);
+  tlsf_heap_allocator<char> alloc(pool);
+  rt::string name(32, "joint", alloc);
+  size_t reserved = pool.stats().bytes_in_use;
+  EXPECT_GT(reserved, 32u);
+
+  name += '_';
+  name.append("state");
+  EXPECT_EQ("joint_state", name.view());
+  name.replace(0, 5, "wheel");
+  EXPECT_TRUE(name == std::string_view("wheel_state"));
+  EXPECT_THROW(name.append(std::string(32, 'x')), std::length_error);
+  EXPECT_THROW(name.resize(33), std::length_error);
+  EXPECT_EQ("wheel_state", std::string(name.c_str()));
+  name.append(21, 'x');
+  EXPECT_EQ(32u, name.size());
+  EXPECT_THROW(name.push_back('x'), std::length_error);
+  EXPECT_EQ(reserved, pool.stats().bytes_in_use);
+
+  rt::string copy(name);
+  EXPECT_EQ(name.view(), copy.view());
+  EXPECT_EQ(32u, copy.capacity());
+}
+
+TEST(RTContainers, unordered_map)
+{
+  tlsf_pool pool(64 * 1024);
+  tlsf_heap_allocator<std::pair<const int, double>> alloc(pool);
+  rt::unordered_map<int, double> gains(3, alloc);
+  size_t buckets = gains.bucket_count();
+
+  gains[1] = 0.1;
+  gains.insert({2, 0.2});
+  gains.try_emplace(3, 0.3);
+  EXPECT_THROW(gains[4], std::length_error);
+  EXPECT_THROW(gains.insert({4, 0.4}), std::length_error);
+  EXPECT_THROW(gains.try_emplace(4, 0.4), std::length_error);
+  gains[1] = 1.0;
+  gains.insert_or_assign(2, 2.0);
+  EXPECT_EQ(3u, gains.size());
+  EXPECT_EQ(buckets, gains.bucket_count());
+  EXPECT_DOUBLE_EQ(2.0, gains.at(2));
+  EXPECT_EQ(0u, gains.count(4));
+
+  gains.erase(3);
+  gains[4] = 0.4;
+  EXPECT_EQ(1u, gains.count(4));
+}
+
+TEST(RTContainers, deque)
+{
+  tlsf_pool pool(64 * 1024);
+  tlsf_heap_allocator<std::string> alloc(pool);
+  rt::deque<std::string> queue(3, alloc);
+  EXPECT_TRUE(queue.empty());
+
+  queue.push_back("b");
+  queue.push_front("a");
+  queue.emplace_back("c");
+  EXPECT_TRUE(queue.full());
+  EXPECT_THROW(queue.push_back("d"), std::length_error);
+  EXPECT_THROW(queue.push_front("d"), std::length_error);
+  EXPECT_EQ("a", queue.front());
+  EXPECT_EQ("c", queue.back());
+  EXPECT_THROW(queue.at(3), std::out_of_range);
+
+  // Wrap around the end of the ring.
+  for (int i = 0; i < 10; ++i) {
+    queue.pop_front();
+    queue.push_back(std::to_string(i));
+  }
+  EXPECT_EQ("7", queue[0]);
+  EXPECT_EQ("9", queue[2]);
+  EXPECT_EQ(3, queue.end() - queue.begin());
+  std::string joined;
+  for (const auto & value : queue) {
+    joined += value;
+  }
+  EXPECT_EQ("789", joined);
+  EXPECT_NE(queue.end(), std::find(queue.begin(), queue.end(), "8"));
+
+  rt::deque<std::string> copy(queue);
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ("8", copy.at(1));
+}
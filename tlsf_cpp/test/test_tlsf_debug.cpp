@@ -0,0 +1,154 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "tlsf_cpp/tlsf_debug_policy.hpp"
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+
+namespace
+{
+
+std::vector<tlsf_debug_failure> g_failures;
+
+void record_failure(const tlsf_debug_failure & failure)
+{
+  g_failures.push_back(failure);
+}
+
+class TLSFDebug : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_failures.clear();
+    tlsf_debug_checks::set_failure_handler(record_failure);
+  }
+
+  void TearDown() override
+  {
+    tlsf_debug_checks::set_failure_handler(nullptr);
+  }
+};
+
+using debug_pool = basic_tlsf_pool<tlsf_no_lock, tlsf_debug_checks>;
+
+}  // namespace
+
+static_assert(
+  std::is_empty<tlsf_no_debug::arena_state>::value,
+  "the release policy must not add state to the pool");
+
+TEST_F(TLSFDebug, poisoning)
+{
+  debug_pool pool(64 * 1024);
+  auto block = static_cast<unsigned char *>(pool.allocate(32, 64));
+  ASSERT_NE(nullptr, block);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 64);
+  EXPECT_EQ(tlsf_debug_checks::allocated_poison, block[0]);
+  EXPECT_EQ(tlsf_debug_checks::allocated_poison, block[31]);
+  memset(block, 0, 32);
+  pool.deallocate(block, 32, 64);
+  EXPECT_EQ(tlsf_debug_checks::freed_poison, block[16]);
+  EXPECT_TRUE(g_failures.empty());
+  EXPECT_EQ(0u, pool.stats().bytes_in_use);
+}
+
+TEST_F(TLSFDebug, overrun_and_double_free)
+{
+  debug_pool pool(64 * 1024);
+  auto overrun = static_cast<char *>(pool.allocate(24));
+  auto valid = static_cast<char *>(pool.allocate(24));
+  EXPECT_EQ(0u, pool.check_consistency());
+
+  overrun[24] = 'x';
+  EXPECT_EQ(1u, pool.check_consistency());
+  ASSERT_EQ(1u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::overrun, g_failures[0].kind);
+  EXPECT_EQ(overrun, g_failures[0].block);
+  EXPECT_EQ(24u, g_failures[0].size);
+
+  pool.deallocate(overrun, 24);
+  ASSERT_EQ(2u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::overrun, g_failures[1].kind);
+
+  pool.deallocate(valid, 24);
+  EXPECT_EQ(2u, g_failures.size());
+  pool.deallocate(valid, 24);
+  ASSERT_EQ(3u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::double_free, g_failures[2].kind);
+
+  auto resized = pool.allocate(16);
+  pool.deallocate(resized, 8);
+  ASSERT_EQ(4u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::size_mismatch, g_failures[3].kind);
+  EXPECT_EQ(16u, g_failures[3].size);
+}
+
+TEST_F(TLSFDebug, background_checker)
+{
+  basic_tlsf_pool<tlsf_pi_mutex, tlsf_debug_checks> pool(64 * 1024);
+  auto block = static_cast<char *>(pool.allocate(8));
+  {
+    tlsf_pool_checker<decltype(pool)> checker(pool, std::chrono::milliseconds(1));
+    while (checker.walks() < 3) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(0u, checker.corrupted_blocks());
+  }
+  EXPECT_TRUE(g_failures.empty());
+  pool.deallocate(block, 8);
+}
+
+TEST_F(TLSFDebug, remote_double_free)
+{
+  debug_pool pool(64 * 1024);
+  pool.set_owner_thread();
+  auto block = static_cast<char *>(pool.allocate(24));
+  std::thread([&pool, block]() {
+      pool.deallocate(block, 24);
+      pool.deallocate(block, 24);
+    }).join();
+  ASSERT_EQ(1u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::double_free, g_failures[0].kind);
+  EXPECT_EQ(1u, pool.drain_remote_frees());
+  EXPECT_EQ(0u, pool.check_consistency());
+  EXPECT_EQ(tlsf_debug_checks::freed_poison, static_cast<unsigned char>(block[0]));
+}
+
+TEST_F(TLSFDebug, remote_free_then_owner_free)
+{
+  debug_pool pool(64 * 1024);
+  pool.set_owner_thread();
+  auto block = static_cast<char *>(pool.allocate(24));
+  std::thread([&pool, block]() {
+      pool.deallocate(block, 24);
+    }).join();
+  // The block is still queued; freeing it directly must not touch the queue links.
+  pool.deallocate(block, 24);
+  ASSERT_EQ(1u, g_failures.size());
+  EXPECT_EQ(tlsf_debug_failure::double_free, g_failures[0].kind);
+  EXPECT_EQ(1u, pool.drain_remote_frees());
+  EXPECT_EQ(1u, g_failures.size());
+  EXPECT_EQ(0u, pool.check_consistency());
+  EXPECT_EQ(tlsf_debug_checks::freed_poison, static_cast<unsigned char>(block[0]));
+}
@@ -0,0 +1,788 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_buffer.hpp"
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_object_pool.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_pool_registry.hpp"
+
+TEST(TLSFPool, usage_counters)
+{
+  tlsf_pool pool(64 * 1024);
+  auto initial = pool.stats();
+  EXPECT_EQ(64u * 1024u, initial.pool_size);
+  EXPECT_GT(initial.capacity, 0u);
+  EXPECT_EQ(0u, initial.bytes_in_use);
+
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 10; ++i) {
+    blocks.push_back(pool.allocate(100));
+  }
+  pool.deallocate(blocks.back(), 100);
+  blocks.pop_back();
+
+  auto stats = pool.stats();
+  EXPECT_EQ(10u, stats.allocation_count);
+  EXPECT_EQ(1u, stats.deallocation_count);
+  EXPECT_EQ(900u, stats.bytes_in_use);
+  EXPECT_EQ(1000u, stats.peak_bytes_in_use);
+  EXPECT_EQ(0u, stats.failed_allocation_count);
+
+  EXPECT_EQ(nullptr, pool.allocate(128 * 1024));
+  EXPECT_EQ(1u, pool.stats().failed_allocation_count);
+
+  for (void * block : blocks) {
+    pool.deallocate(block, 100);
+  }
+  EXPECT_EQ(0u, pool.stats().bytes_in_use);
+}
+
+TEST(TLSFPool, inspect_fragmentation)
+{
+  tlsf_pool pool(256 * 1024);
+  size_t empty_largest = pool.inspect();
+  EXPECT_GT(empty_largest, 0u);
+  EXPECT_NEAR(0.0, pool.stats().fragmentation, 0.05);
+
+  // Interleave kept and freed blocks so that the free memory is scattered.
+  std::vector<void *> kept;
+  std::vector<void *> freed;
+  for (size_t i = 0; i < 64; ++i) {
+    kept.push_back(pool.allocate(1024));
+    freed.push_back(pool.allocate(1024));
+  }
+  // Leave the tail of the pool allocated as well.
+  size_t tail_size = pool.inspect() / 2;
+  void * tail = pool.allocate(tail_size);
+  size_t before_free = pool.inspect();
+  for (void * block : freed) {
+    pool.deallocate(block, 1024);
+  }
+  size_t largest = pool.inspect();
+  EXPECT_EQ(before_free, largest);
+  auto stats = pool.stats();
+  EXPECT_EQ(largest, stats.largest_free_block);
+  EXPECT_GT(stats.fragmentation, 0.3);
+  EXPECT_EQ(4u, stats.inspection_count);
+
+  // Inspection must leave the pool usable and unchanged.
+  for (void * block : kept) {
+    pool.deallocate(block, 1024);
+  }
+  pool.deallocate(tail, tail_size);
+  EXPECT_EQ(empty_largest, pool.inspect());
+}
+
+TEST(TLSFPool, inspect_keeps_max_used_size)
+{
+  tlsf_pool pool(256 * 1024);
+  void * block = pool.allocate(4096);
+  size_t max_used_size = pool.stats().max_used_size;
+  EXPECT_LT(max_used_size, pool.stats().capacity / 2);
+
+  // The trial allocations of inspect() and trim() are not usage.
+  pool.inspect();
+  pool.trim();
+  EXPECT_EQ(max_used_size, pool.stats().max_used_size);
+
+  pool.deallocate(block, 4096);
+  EXPECT_EQ(max_used_size, pool.stats().max_used_size);
+  pool.reset_stats();
+  EXPECT_EQ(pool.stats().used_size, pool.stats().max_used_size);
+}
+
+TEST(TLSFPool, trim)
+{
+  constexpr size_t size = 4 * 1024 * 1024;
+  void * memory = mmap(
+    nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(MAP_FAILED, memory);
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> pages(size / page_size);
+  auto resident_bytes = [&]() {
+      mincore(memory, size, pages.data());
+      size_t resident = 0;
+      for (unsigned char page : pages) {
+        resident += (page & 1) * page_size;
+      }
+      return resident;
+    };
+  {
+    basic_tlsf_pool<tlsf_pi_mutex> pool(memory, size);
+    void * kept = pool.allocate(1000);
+    memset(kept, 1, 1000);
+    EXPECT_EQ(size, resident_bytes());
+
+    size_t largest = pool.inspect();
+
+    // Nothing beyond the reserve is released.
+    EXPECT_EQ(0u, pool.trim(size));
+    EXPECT_EQ(0u, pool.trim(SIZE_MAX));
+    size_t released = pool.trim(512 * 1024);
+    EXPECT_GT(released, 2u * 1024u * 1024u);
+    EXPECT_LE(released, size - 512 * 1024);
+    EXPECT_EQ(released, pool.stats().trimmed_bytes);
+    EXPECT_LE(resident_bytes(), size - released);
+
+    // The released pages are usable again and the pool is left as it was.
+    EXPECT_EQ(largest, pool.inspect());
+    void * block = pool.allocate(largest / 2);
+    ASSERT_NE(nullptr, block);
+    memset(block, 2, largest / 2);
+    pool.deallocate(block, largest / 2);
+    EXPECT_EQ(1, static_cast<unsigned char *>(kept)[999]);
+    pool.deallocate(kept, 1000);
+  }
+  munmap(memory, size);
+}
+
+TEST(TLSFPool, latency_histograms)
+{
+  tlsf_pool pool(64 * 1024);
+  pool.deallocate(pool.allocate(64), 64);
+  EXPECT_EQ(0u, pool.stats().allocate_latency.count);
+
+  pool.enable_latency_histograms(true);
+  for (size_t i = 0; i < 100; ++i) {
+    pool.deallocate(pool.allocate(64), 64);
+  }
+  auto stats = pool.stats();
+  EXPECT_EQ(100u, stats.allocate_latency.count);
+  EXPECT_EQ(100u, stats.deallocate_latency.count);
+  uint64_t bucketed = 0;
+  for (auto bucket : stats.allocate_latency.buckets) {
+    bucketed += bucket;
+  }
+  EXPECT_EQ(100u, bucketed);
+  EXPECT_LE(
+    stats.allocate_latency.percentile_upper_bound_ns(0.5),
+    2 * stats.allocate_latency.max_ns + 2);
+
+  pool.reset_stats();
+  EXPECT_EQ(0u, pool.stats().allocate_latency.count);
+}
+
+TEST(TLSFPool, stats_from_another_thread)
+{
+  tlsf_heap_allocator<int> alloc(64 * 1024);
+  std::atomic<bool> done{false};
+  std::thread reader([&alloc, &done]() {
+      while (!done.load()) {
+        auto stats = alloc.pool->stats();
+        EXPECT_LE(stats.bytes_in_use, stats.peak_bytes_in_use);
+      }
+    });
+  for (size_t i = 0; i < 10000; ++i) {
+    alloc.deallocate(alloc.allocate(4), 4);
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(10000u, alloc.pool->stats().allocation_count);
+}
+
+struct HotMessage
+{
+  uint64_t stamp;
+  uint32_t data[6];
+};
+
+// Allocate and free from several threads at once; every block must stay intact until freed.
+template<typename LockPolicy>
+tlsf_pool_stats hammer_pool(basic_tlsf_pool<LockPolicy> & pool)
+{
+  constexpr size_t thread_count = 4;
+  constexpr size_t iterations = 2000;
+  pool.enable_latency_histograms(true);
+  std::atomic<bool> corrupted{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&pool, &corrupted, t]() {
+        std::vector<uint64_t *> blocks;
+        for (size_t i = 0; i < iterations; ++i) {
+          auto block = static_cast<uint64_t *>(pool.allocate(sizeof(uint64_t) * (1 + i % 8)));
+          if (block == nullptr) {
+            corrupted = true;
+            return;
+          }
+          *block = t * iterations + i;
+          blocks.push_back(block);
+          if (blocks.size() > 16) {
+            uint64_t * oldest = blocks.front();
+            if (*oldest != t * iterations + i - 16) {
+              corrupted = true;
+            }
+            pool.deallocate(oldest, sizeof(uint64_t) * (1 + (i - 16) % 8));
+            blocks.erase(blocks.begin());
+          }
+        }
+        for (size_t j = 0; j < blocks.size(); ++j) {
+          pool.deallocate(blocks[j], sizeof(uint64_t) * (1 + (iterations - 16 + j) % 8));
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(corrupted.load());
+  auto stats = pool.stats();
+  EXPECT_EQ(thread_count * iterations, stats.allocation_count);
+  EXPECT_EQ(thread_count * iterations, stats.deallocation_count);
+  EXPECT_EQ(0u, stats.bytes_in_use);
+  EXPECT_EQ(0u, stats.failed_allocation_count);
+  return stats;
+}
+
+TEST(TLSFLockPolicy, no_lock_has_no_lock_stats)
+{
+  tlsf_pool pool(64 * 1024);
+  pool.deallocate(pool.allocate(64), 64);
+  EXPECT_EQ(0u, pool.stats().lock.acquisitions);
+}
+
+TEST(TLSFLockPolicy, pi_mutex)
+{
+  basic_tlsf_pool<tlsf_pi_mutex> pool(256 * 1024);
+  auto stats = hammer_pool(pool);
+  EXPECT_EQ(stats.allocation_count + stats.deallocation_count, stats.lock.acquisitions);
+  EXPECT_LE(stats.lock.contended_acquisitions, stats.lock.acquisitions);
+  EXPECT_LE(stats.lock.max_hold_ns, stats.lock.total_hold_ns);
+  EXPECT_LE(stats.lock.max_wait_ns, stats.lock.total_wait_ns);
+}
+
+TEST(TLSFLockPolicy, ticket_spinlock)
+{
+  basic_tlsf_pool<tlsf_ticket_spinlock> pool(256 * 1024);
+  auto stats = hammer_pool(pool);
+  EXPECT_EQ(stats.allocation_count + stats.deallocation_count, stats.lock.acquisitions);
+}
+
+TEST(TLSFLockPolicy, ticket_spinlock_try_lock)
+{
+  tlsf_ticket_spinlock lock;
+  EXPECT_TRUE(lock.try_lock());
+  EXPECT_FALSE(lock.try_lock());
+  lock.unlock();
+  lock.lock();
+  EXPECT_FALSE(lock.try_lock());
+  lock.unlock();
+  EXPECT_TRUE(lock.try_lock());
+  lock.unlock();
+}
+
+TEST(TLSFLockPolicy, per_thread_pools)
+{
+  using pool_type = basic_tlsf_pool<tlsf_per_thread_pools<4>>;
+  static_assert(pool_type::arena_count == 4, "expected four arenas");
+  pool_type pool(1024 * 1024);
+  hammer_pool(pool);
+
+  // A block freed by another thread goes back to the arena it came from.
+  void * block = pool.allocate(128);
+  ASSERT_NE(nullptr, block);
+  std::thread([&pool, block]() {pool.deallocate(block, 128);}).join();
+  EXPECT_EQ(0u, pool.stats().bytes_in_use);
+}
+
+TEST(TLSFLockPolicy, per_thread_pools_spill)
+{
+  basic_tlsf_pool<tlsf_per_thread_pools<2>> pool(64 * 1024);
+  // Larger than one arena can hold in total, so the second half must come from the other one.
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 12; ++i) {
+    void * block = pool.allocate(4 * 1024);
+    ASSERT_NE(nullptr, block);
+    blocks.push_back(block);
+  }
+  for (void * block : blocks) {
+    pool.deallocate(block, 4 * 1024);
+  }
+  EXPECT_EQ(0u, pool.stats().failed_allocation_count);
+}
+
+TEST(TLSFLockPolicy, shared_allocator_and_slab)
+{
+  using alloc_type = tlsf_object_pool_allocator<uint64_t, uint64_t, 8, 64 * 1024, tlsf_pi_mutex>;
+  alloc_type alloc;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([alloc]() mutable {
+        for (size_t i = 0; i < 1000; ++i) {
+          uint64_t * value = alloc.allocate(1);
+          *value = i;
+          alloc.deallocate(value, 1);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(8u, alloc.slab->available());
+
+  tlsf_heap_allocator<int, 1024 * 1024, tlsf_ticket_spinlock> heap_alloc(64 * 1024);
+  std::allocator_traits<decltype(heap_alloc)>::rebind_alloc<double> rebound(heap_alloc);
+  EXPECT_EQ(heap_alloc.pool, rebound.pool);
+  EXPECT_TRUE(heap_alloc == rebound);
+}
+
+TEST(TLSFObjectPool, slab_and_fallback)
+{
+  using Alloc = tlsf_object_pool_allocator<HotMessage, HotMessage, 4>;
+  using Traits = std::allocator_traits<Alloc>;
+  Alloc alloc(64 * 1024);
+  tlsf_object_slab & slab = *alloc.slab;
+  EXPECT_EQ(4u, slab.available());
+
+  std::vector<HotMessage *> messages;
+  for (size_t i = 0; i < 4; ++i) {
+    messages.push_back(Traits::allocate(alloc, 1));
+    EXPECT_TRUE(slab.contains(messages.back()));
+  }
+  EXPECT_EQ(0u, slab.available());
+  // Adjacent slots: the slab is one contiguous block.
+  EXPECT_EQ(messages[0] + 1, messages[1]);
+
+  uint64_t pool_allocations = alloc.pool->stats().allocation_count;
+  HotMessage * overflow = Traits::allocate(alloc, 1);
+  EXPECT_FALSE(slab.contains(overflow));
+  HotMessage * array = Traits::allocate(alloc, 3);
+  EXPECT_FALSE(slab.contains(array));
+  EXPECT_EQ(pool_allocations + 2, alloc.pool->stats().allocation_count);
+
+  Traits::deallocate(alloc, overflow, 1);
+  Traits::deallocate(alloc, array, 3);
+  Traits::deallocate(alloc, messages[2], 1);
+  EXPECT_EQ(1u, slab.available());
+  // The freed slot is reused first.
+  EXPECT_EQ(messages[2], Traits::allocate(alloc, 1));
+
+  // Steady state: recycling through the slab never reaches the TLSF pool.
+  pool_allocations = alloc.pool->stats().allocation_count;
+  for (size_t i = 0; i < 1000; ++i) {
+    Traits::deallocate(alloc, messages[i % 4], 1);
+    messages[i % 4] = Traits::allocate(alloc, 1);
+  }
+  EXPECT_EQ(pool_allocations, alloc.pool->stats().allocation_count);
+  for (auto message : messages) {
+    Traits::deallocate(alloc, message, 1);
+  }
+  EXPECT_EQ(4u, slab.available());
+}
+
+TEST(TLSFObjectPool, rebind_shares_slab)
+{
+  using Alloc = tlsf_object_pool_allocator<void, HotMessage, 8>;
+  Alloc alloc(64 * 1024);
+
+  // Node-based containers allocate nodes of other types, which go to the pool.
+  std::list<int, std::allocator_traits<Alloc>::rebind_alloc<int>> values(alloc);
+  values.assign(10, 1);
+  EXPECT_EQ(8u, alloc.slab->available());
+
+  std::allocator_traits<Alloc>::rebind_alloc<HotMessage> message_alloc(alloc);
+  EXPECT_TRUE(alloc == message_alloc);
+  HotMessage * message = message_alloc.allocate(1);
+  EXPECT_EQ(7u, alloc.slab->available());
+  message_alloc.deallocate(message, 1);
+
+  Alloc other(64 * 1024);
+  EXPECT_TRUE(alloc != other);
+}
+
+TEST(TLSFObjectPool, slab_in_existing_pool)
+{
+  tlsf_pool pool(64 * 1024);
+  {
+    tlsf_object_pool_allocator<HotMessage, HotMessage, 16> alloc(pool);
+    EXPECT_TRUE(pool.contains(alloc.slab->allocate()));
+    EXPECT_GE(pool.stats().bytes_in_use, 16 * sizeof(HotMessage));
+  }
+  EXPECT_EQ(0u, pool.stats().bytes_in_use);
+}
+
+TEST(TLSFPoolRegistry, named_pools)
+{
+  tlsf_pool_registry registry;
+  registry.configure("default=64kb,sensors=128kb,raw=4096");
+  EXPECT_TRUE(registry.is_configured("sensors"));
+  EXPECT_FALSE(registry.is_configured("planning"));
+  EXPECT_EQ(0u, registry.total_size());
+
+  tlsf_pool & sensors = registry.acquire("sensors");
+  EXPECT_EQ(128u * 1024u, sensors.size());
+  EXPECT_EQ(&sensors, &registry.acquire("sensors"));
+  sensors.release();
+  tlsf_pool & planning = registry.acquire("planning", 64 * 1024);
+  EXPECT_EQ(64u * 1024u, planning.size());
+  planning.release();
+  EXPECT_THROW(registry.acquire("unknown"), std::out_of_range);
+  EXPECT_EQ(192u * 1024u, registry.total_size());
+
+  auto pools = registry.pools();
+  ASSERT_EQ(4u, pools.size());
+  EXPECT_EQ("default", pools[0].name);
+  EXPECT_FALSE(pools[0].created);
+  EXPECT_EQ("sensors", pools[3].name);
+  EXPECT_TRUE(pools[3].created);
+  EXPECT_EQ(128u * 1024u, pools[3].stats.pool_size);
+
+  EXPECT_NO_THROW(registry.set_size("sensors", 128 * 1024));
+  EXPECT_THROW(registry.set_size("sensors", 256 * 1024), std::logic_error);
+  EXPECT_THROW(registry.configure("sensors"), std::invalid_argument);
+  EXPECT_THROW(registry.configure("=1mb"), std::invalid_argument);
+  EXPECT_THROW(registry.configure("a=1tb"), std::invalid_argument);
+  sensors.release();
+}
+
+TEST(TLSFPoolRegistry, malformed_sizes)
+{
+  tlsf_pool_registry registry;
+  for (const char * config : {"a=-1", "a=-1mb", "a=+1mb", "a= 1mb", "a=mb", "a=",
+      "a=20000000000gb", "a=18446744073709551616", "a=17592186044416mb"})
+  {
+    EXPECT_THROW(registry.configure(config), std::invalid_argument) << config;
+  }
+  EXPECT_FALSE(registry.is_configured("a"));
+  EXPECT_NO_THROW(registry.configure("a=17592186044415mb"));
+  EXPECT_TRUE(registry.is_configured("a"));
+}
+
+TEST(TLSFPoolRegistry, one_pool_per_name)
+{
+  tlsf_pool_registry registry;
+  registry.configure("shared=64kb");
+  auto & pool = registry.acquire<tlsf_pi_mutex>("shared");
+  // A second lock policy gets neither a pool of its own nor the unsynchronized view of it.
+  EXPECT_THROW(registry.acquire<tlsf_ticket_spinlock>("shared"), std::logic_error);
+  EXPECT_THROW(registry.acquire("shared"), std::logic_error);
+  EXPECT_EQ(&pool, &registry.acquire<tlsf_pi_mutex>("shared"));
+  EXPECT_EQ(64u * 1024u, registry.total_size());
+  ASSERT_EQ(1u, registry.pools().size());
+  EXPECT_TRUE(registry.pools()[0].created);
+  pool.release();
+  pool.release();
+}
+
+TEST(TLSFPoolRegistry, default_allocators_share_pool)
+{
+  using Alloc = tlsf_heap_allocator<int, 1024 * 1024, tlsf_pi_mutex>;
+  using UnlockedAlloc = tlsf_heap_allocator<int, 1024 * 1024>;
+  auto & registry = tlsf_pool_registry::instance();
+  {
+    // Without a configured default pool, every allocator gets its own.
+    Alloc a;
+    Alloc b;
+    EXPECT_TRUE(a != b);
+    EXPECT_EQ(1024u * 1024u, a.pool_size);
+  }
+
+  registry.set_size(tlsf_pool_registry::default_pool_name, 256 * 1024);
+  Alloc a;
+  Alloc b;
+  EXPECT_TRUE(a == b);
+  EXPECT_EQ(256u * 1024u, a.pool_size);
+  std::vector<int, Alloc> values(a);
+  values.resize(100);
+  EXPECT_GT(registry.pools()[0].stats.bytes_in_use, 0u);
+
+  // Allocators without a lock never share the default pool implicitly.
+  UnlockedAlloc unlocked_a;
+  UnlockedAlloc unlocked_b;
+  EXPECT_TRUE(unlocked_a != unlocked_b);
+  EXPECT_EQ(1024u * 1024u, unlocked_a.pool_size);
+  EXPECT_THROW(UnlockedAlloc(std::string("default")), std::logic_error);
+  EXPECT_EQ(256u * 1024u, registry.total_size());
+
+  Alloc named(std::string("named"));
+  EXPECT_TRUE(named != a);
+  EXPECT_EQ(1024u * 1024u, named.pool_size);
+  EXPECT_TRUE(named == Alloc(std::string("named")));
+}
+
+TEST(TLSFRemoteFree, consumer_frees_through_queue)
+{
+  constexpr size_t message_count = 20000;
+  constexpr size_t ring_size = 64;
+  tlsf_pool pool(64 * 1024);
+  pool.set_owner_thread();
+
+  // Hand the blocks over to a consumer thread, which frees them.
+  std::atomic<uint64_t *> ring[ring_size];
+  for (auto & slot : ring) {
+    slot.store(nullptr);
+  }
+  std::atomic<bool> corrupted{false};
+  std::thread consumer([&ring, &corrupted, &pool]() {
+      for (size_t i = 0; i < message_count; ++i) {
+        uint64_t * block;
+        while ((block = ring[i % ring_size].exchange(nullptr)) == nullptr) {
+          std::this_thread::yield();
+        }
+        if (*block != i) {
+          corrupted = true;
+        }
+        pool.deallocate(block, 2 * sizeof(uint64_t));
+      }
+    });
+  for (size_t i = 0; i < message_count; ++i) {
+    auto block = static_cast<uint64_t *>(pool.allocate(2 * sizeof(uint64_t)));
+    ASSERT_NE(nullptr, block);
+    *block = i;
+    while (ring[i % ring_size].load() != nullptr) {
+      std::this_thread::yield();
+    }
+    ring[i % ring_size].store(block);
+  }
+  consumer.join();
+  EXPECT_FALSE(corrupted.load());
+
+  auto stats = pool.stats();
+  EXPECT_EQ(message_count, stats.remote_deallocation_count);
+  EXPECT_EQ(message_count, stats.deallocation_count);
+  EXPECT_EQ(0u, stats.bytes_in_use);
+  EXPECT_EQ(0u, stats.failed_allocation_count);
+  EXPECT_EQ(stats.pending_remote_frees, pool.drain_remote_frees());
+  EXPECT_EQ(0u, pool.stats().pending_remote_frees);
+
+  // The owner frees directly.
+  pool.deallocate(pool.allocate(8), 8);
+  EXPECT_EQ(message_count, pool.stats().remote_deallocation_count);
+}
+
+TEST(TLSFBatch, single_lock_acquisition)
+{
+  basic_tlsf_pool<tlsf_pi_mutex> pool(64 * 1024);
+  void * blocks[16];
+  ASSERT_TRUE(pool.allocate_batch(blocks, 16, 100, 32));
+  EXPECT_EQ(1u, pool.stats().lock.acquisitions);
+  for (size_t i = 0; i < 16; ++i) {
+    ASSERT_NE(nullptr, blocks[i]);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(blocks[i]) % 32);
+    memset(blocks[i], static_cast<int>(i), 100);
+  }
+  auto stats = pool.stats();
+  EXPECT_EQ(16u, stats.allocation_count);
+  EXPECT_EQ(1600u, stats.bytes_in_use);
+
+  blocks[3] = nullptr;
+  pool.deallocate_batch(blocks, 16, 100, 32);
+  stats = pool.stats();
+  EXPECT_EQ(2u, stats.lock.acquisitions);
+  EXPECT_EQ(15u, stats.deallocation_count);
+  EXPECT_EQ(100u, stats.bytes_in_use);
+}
+
+TEST(TLSFBatch, all_or_nothing)
+{
+  tlsf_pool pool(16 * 1024);
+  void * blocks[64];
+  EXPECT_FALSE(pool.allocate_batch(blocks, 64, 1024));
+  for (void * block : blocks) {
+    EXPECT_EQ(nullptr, block);
+  }
+  auto stats = pool.stats();
+  EXPECT_EQ(0u, stats.allocation_count);
+  EXPECT_EQ(1u, stats.failed_allocation_count);
+  EXPECT_EQ(0u, stats.bytes_in_use);
+  EXPECT_TRUE(pool.allocate_batch(blocks, 8, 1024));
+  pool.deallocate_batch(blocks, 8, 1024);
+}
+
+TEST(TLSFBatch, allocator)
+{
+  tlsf_heap_allocator<uint64_t> alloc(64 * 1024);
+  uint64_t * arrays[8];
+  alloc.allocate_batch(arrays, 8, 4);
+  for (size_t i = 0; i < 8; ++i) {
+    arrays[i][3] = i;
+  }
+  EXPECT_EQ(8u * 4u * sizeof(uint64_t), alloc.pool->stats().bytes_in_use);
+  // Batches and single calls mix freely.
+  alloc.deallocate(arrays[0], 4);
+  arrays[0] = nullptr;
+  alloc.deallocate_batch(arrays, 8, 4);
+  EXPECT_EQ(0u, alloc.pool->stats().bytes_in_use);
+  EXPECT_THROW(alloc.allocate_batch(arrays, 8, 64 * 1024), std::bad_alloc);
+}
+
+TEST(TLSFClient, quota_and_peak)
+{
+  tlsf_heap_allocator<char> untagged(256 * 1024);
+  auto camera = tlsf_heap_allocator<char>(untagged).set_client(1);
+  auto planner = tlsf_heap_allocator<char>(untagged).set_client(2);
+  untagged.pool->set_client_quota(1, 4096);
+  EXPECT_THROW(untagged.set_client(untagged.pool->max_clients), std::out_of_range);
+  EXPECT_EQ(0u, untagged.client());
+  EXPECT_EQ(1u, camera.client());
+  EXPECT_FALSE(untagged.pool->charge_client(untagged.pool->max_clients, 1));
+  untagged.pool->credit_client(untagged.pool->max_clients, 1);
+
+  char * frame = camera.allocate(3000);
+  // Copies and rebinds keep charging the same client.
+  tlsf_heap_allocator<int> rebound(camera);
+  std::vector<int, tlsf_heap_allocator<int>> samples(rebound);
+  samples.resize(200);
+  EXPECT_THROW(camera.allocate(1000), std::bad_alloc);
+  // The other clients are not affected by the quota.
+  char * plan = planner.allocate(8000);
+  char * rest = untagged.allocate(8000);
+
+  auto camera_stats = untagged.pool->client_stats(1);
+  EXPECT_EQ(3000u + 200u * sizeof(int), camera_stats.bytes_in_use);
+  EXPECT_EQ(4096u, camera_stats.quota);
+  EXPECT_EQ(1u, camera_stats.rejected_allocation_count);
+  EXPECT_EQ(8000u, untagged.pool->client_stats(2).bytes_in_use);
+
+  camera.deallocate(frame, 3000);
+  planner.deallocate(plan, 8000);
+  untagged.deallocate(rest, 8000);
+  samples.clear();
+  samples.shrink_to_fit();
+  auto report = untagged.pool->client_report();
+  ASSERT_EQ(2u, report.size());
+  EXPECT_EQ(1u, report[0].client);
+  EXPECT_EQ(0u, report[0].bytes_in_use);
+  EXPECT_EQ(3000u + 200u * sizeof(int), report[0].peak_bytes_in_use);
+  EXPECT_EQ(2u, report[1].client);
+  EXPECT_EQ(8000u, report[1].peak_bytes_in_use);
+  EXPECT_EQ(0u, untagged.pool->stats().bytes_in_use);
+}
+
+TEST(TLSFReallocate, in_place)
+{
+  // Debug checks move every block, see reallocate().
+  basic_tlsf_pool<tlsf_no_lock, tlsf_no_debug> pool(64 * 1024);
+  auto block = static_cast<char *>(pool.allocate(100));
+  memset(block, 'a', 100);
+  // The rest of the pool is free, so the block can grow where it is.
+  auto grown = static_cast<char *>(pool.reallocate(block, 100, 4000));
+  ASSERT_EQ(block, grown);
+  EXPECT_EQ('a', grown[99]);
+  EXPECT_EQ(4000u, pool.stats().bytes_in_use);
+  EXPECT_EQ(block, pool.reallocate(grown, 4000, 200));
+
+  // A block in the way forces a move, which keeps the contents.
+  void * neighbor = pool.allocate(100);
+  auto moved = static_cast<char *>(pool.reallocate(block, 200, 8000));
+  ASSERT_NE(nullptr, moved);
+  EXPECT_NE(block, moved);
+  EXPECT_EQ('a', moved[0]);
+  EXPECT_EQ('a', moved[99]);
+  auto stats = pool.stats();
+  EXPECT_EQ(3u, stats.reallocation_count);
+  EXPECT_EQ(2u, stats.in_place_reallocation_count);
+  EXPECT_EQ(8100u, stats.bytes_in_use);
+
+  EXPECT_EQ(nullptr, pool.reallocate(moved, 8000, 1024 * 1024));
+  EXPECT_EQ('a', moved[50]);
+  pool.deallocate(moved, 8000);
+  pool.deallocate(neighbor, 100);
+  EXPECT_EQ(0u, pool.stats().bytes_in_use);
+}
+
+TEST(TLSFReallocate, buffer)
+{
+  tlsf_heap_allocator<uint32_t> alloc(64 * 1024);
+  tlsf_buffer<uint32_t> buffer(alloc);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    buffer.push_back(i);
+  }
+  ASSERT_EQ(1000u, buffer.size());
+  EXPECT_GE(buffer.capacity(), 1000u);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(i, buffer[i]);
+  }
+  if (!tlsf_pool::debug_policy::enabled) {
+    // Alone in its pool, the buffer never had to move.
+    auto stats = alloc.pool->stats();
+    EXPECT_EQ(stats.reallocation_count, stats.in_place_reallocation_count);
+    EXPECT_EQ(buffer.capacity() * sizeof(uint32_t), stats.peak_bytes_in_use);
+  }
+
+  uint32_t tail[] = {7, 8, 9};
+  buffer.append(tail, 3);
+  EXPECT_EQ(9u, buffer[1002]);
+  buffer.shrink_to_fit();
+  EXPECT_EQ(1003u, buffer.capacity());
+  EXPECT_EQ(1003u * sizeof(uint32_t), alloc.pool->stats().bytes_in_use);
+  EXPECT_THROW(buffer.reserve(1024 * 1024), std::bad_alloc);
+  EXPECT_EQ(1003u, buffer.size());
+
+  tlsf_buffer<uint32_t> moved(std::move(buffer));
+  EXPECT_EQ(7u, moved[1000]);
+  moved.clear();
+  moved.shrink_to_fit();
+  EXPECT_EQ(0u, alloc.pool->stats().bytes_in_use);
+}
+
+namespace
+{
+
+// Constructed before main, from .bss.
+static_tlsf_pool<64 * 1024, tlsf_pi_mutex> g_static_pool;
+
+}  // namespace
+
+TEST(TLSFStaticPool, static_storage)
+{
+  EXPECT_TRUE(g_static_pool.contains(g_static_pool.data()));
+  EXPECT_EQ(64u * 1024u, g_static_pool.size());
+  {
+    tlsf_heap_allocator<int, 1024 * 1024, tlsf_pi_mutex> alloc(g_static_pool);
+    std::vector<int, decltype(alloc)> numbers(alloc);
+    numbers.assign(1000, 7);
+    EXPECT_TRUE(g_static_pool.contains(numbers.data()));
+    EXPECT_EQ(1000u * sizeof(int), g_static_pool.stats().bytes_in_use);
+  }
+  // Dropping the last allocator leaves the pool alone.
+  EXPECT_EQ(0u, g_static_pool.stats().bytes_in_use);
+  void * block = g_static_pool.allocate(60 * 1024);
+  EXPECT_NE(nullptr, block);
+  g_static_pool.deallocate(block, 60 * 1024);
+}
+
+TEST(TLSFStaticPool, caller_buffer)
+{
+  alignas(std::max_align_t) static char buffer[32 * 1024];
+  {
+    tlsf_pool pool(buffer, sizeof(buffer));
+    void * block = pool.allocate(1000);
+    EXPECT_GE(static_cast<char *>(block), buffer);
+    EXPECT_LT(static_cast<char *>(block), buffer + sizeof(buffer));
+    EXPECT_EQ(nullptr, pool.allocate(sizeof(buffer)));
+    pool.deallocate(block, 1000);
+  }
+  // The buffer outlives the pool and can host another one.
+  tlsf_pool pool(buffer, sizeof(buffer));
+  EXPECT_NE(nullptr, pool.allocate(1000));
+
+  EXPECT_THROW(tlsf_pool(buffer + 1, 1024), std::invalid_argument);
+  EXPECT_THROW(tlsf_pool(nullptr, 1024), std::invalid_argument);
+}
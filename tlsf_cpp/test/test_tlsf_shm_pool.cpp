@@ -0,0 +1,203 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "tlsf_cpp/tlsf_lock_policy.hpp"
+#include "tlsf_cpp/tlsf_shm_pool.hpp"
+
+namespace
+{
+
+std::string segment_name(const char * test)
+{
+  return "/tlsf_cpp_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+tlsf_shm_options test_options()
+{
+  tlsf_shm_options options;
+  // Test machines often limit how much memory a process may lock.
+  options.lock_memory = false;
+  return options;
+}
+
+int wait_for(pid_t child)
+{
+  int status = 0;
+  waitpid(child, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+class TLSFShmPool : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    tlsf_shm_pool::unlink(name);
+  }
+
+  std::string name = segment_name(
+    ::testing::UnitTest::GetInstance()->current_test_info()->name());
+};
+
+}  // namespace
+
+TEST_F(TLSFShmPool, handles_across_processes)
+{
+  int to_child[2];
+  int to_parent[2];
+  ASSERT_EQ(0, pipe(to_child));
+  ASSERT_EQ(0, pipe(to_parent));
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    // Maps the segment created by the parent after the fork, at the address it chose.
+    int status = 1;
+    tlsf_shm_handle<char> ping;
+    if (read(to_child[0], &ping, sizeof(ping)) == sizeof(ping)) {
+      try {
+        auto shm = tlsf_shm_pool::open(name, test_options());
+        const char * text = shm.get(ping);
+        if (!shm.created() && text != nullptr && strcmp(text, "ping") == 0) {
+          tlsf_shm_allocator<char> alloc(shm);
+          auto pong = alloc.allocate_handle(5);
+          memcpy(shm.get(pong), "pong", 5);
+          alloc.deallocate(ping, 5);
+          status = write(to_parent[1], &pong, sizeof(pong)) == sizeof(pong) ? 0 : 1;
+        }
+      } catch (...) {
+      }
+    }
+    _exit(status);
+  }
+  close(to_parent[1]);
+
+  auto shm = tlsf_shm_pool::create(name, 1024 * 1024, test_options());
+  EXPECT_TRUE(shm.created());
+  tlsf_shm_allocator<char> alloc(shm);
+  auto ping = alloc.allocate_handle(5);
+  memcpy(shm.get(ping), "ping", 5);
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(ping)), write(to_child[1], &ping, sizeof(ping)));
+  tlsf_shm_handle<char> pong;
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(pong)), read(to_parent[0], &pong, sizeof(pong)));
+  EXPECT_EQ(0, wait_for(child));
+
+  EXPECT_STREQ("pong", shm.get(pong));
+  auto stats = shm.stats();
+  EXPECT_EQ(2u, stats.allocation_count);
+  EXPECT_EQ(5u, stats.bytes_in_use);
+  alloc.deallocate(pong, 5);
+
+  EXPECT_EQ(nullptr, shm.get(tlsf_shm_handle<char>{}));
+  EXPECT_EQ(nullptr, shm.get(tlsf_shm_handle<char>{8}));
+  EXPECT_EQ(nullptr, shm.get(tlsf_shm_handle<char>{shm.size()}));
+  EXPECT_THROW(tlsf_shm_pool::create(name, 1024 * 1024, test_options()), std::system_error);
+  close(to_child[0]);
+  close(to_child[1]);
+  close(to_parent[0]);
+}
+
+TEST_F(TLSFShmPool, dead_lock_holder)
+{
+  auto shm = tlsf_shm_pool::create(name, 1024 * 1024, test_options());
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    // Die holding the pool lock, as if killed in the middle of an allocation.
+    const_cast<tlsf_robust_pi_mutex &>(shm.pool().arena_lock(0)).lock();
+    _exit(0);
+  }
+  ASSERT_EQ(0, wait_for(child));
+
+  // Would wait forever on a mutex that is not robust.
+  void * block = shm.allocate(100);
+  EXPECT_NE(nullptr, block);
+  EXPECT_EQ(1u, shm.owner_deaths());
+  shm.deallocate(block, 100);
+  EXPECT_EQ(0u, shm.pool().check_consistency());
+}
+
+TEST_F(TLSFShmPool, outlives_creator)
+{
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    int status = 1;
+    try {
+      auto shm = tlsf_shm_pool::open_or_create(name, 1024 * 1024, test_options());
+      status = shm.created() && shm.allocate(100) != nullptr ? 0 : 1;
+    } catch (...) {
+    }
+    _exit(status);
+  }
+  ASSERT_EQ(0, wait_for(child));
+
+  // The block of the dead creator is still allocated.
+  auto shm = tlsf_shm_pool::open_or_create(name, 1024 * 1024, test_options());
+  EXPECT_FALSE(shm.created());
+  EXPECT_EQ(100u, shm.stats().bytes_in_use);
+  shm.reset();
+  EXPECT_EQ(0u, shm.stats().bytes_in_use);
+  void * block = shm.allocate(512 * 1024);
+  EXPECT_NE(nullptr, block);
+  shm.deallocate(block, 512 * 1024);
+
+  EXPECT_THROW(tlsf_shm_pool::open(name + "_missing", test_options()), std::system_error);
+}
+
+TEST_F(TLSFShmPool, abandoned_initialization)
+{
+  pid_t dead = fork();
+  ASSERT_GE(dead, 0);
+  if (dead == 0) {
+    _exit(0);
+  }
+  ASSERT_EQ(0, wait_for(dead));
+
+  // A segment whose creator died while initializing it; the header starts with the state word,
+  // holding the pid of the initializing process and the phase.
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(0, ftruncate(fd, 4096));
+  void * header = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ASSERT_NE(MAP_FAILED, header);
+  static_cast<std::atomic<uint64_t> *>(header)->store(static_cast<uint64_t>(dead) << 2 | 1);
+  munmap(header, 4096);
+  close(fd);
+
+  auto options = test_options();
+  options.open_timeout = std::chrono::milliseconds(10);
+  EXPECT_THROW(tlsf_shm_pool::open(name, options), std::runtime_error);
+
+  auto shm = tlsf_shm_pool::open_or_create(name, 1024 * 1024, options);
+  EXPECT_TRUE(shm.created());
+  EXPECT_EQ(1024u * 1024u, shm.size());
+  void * block = shm.allocate(1000);
+  EXPECT_NE(nullptr, block);
+  shm.deallocate(block, 1000);
+}
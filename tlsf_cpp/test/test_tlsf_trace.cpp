@@ -0,0 +1,132 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <memory_resource>
+#include <sstream>
+#include <vector>
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_pool.hpp"
+#include "tlsf_cpp/tlsf_trace.hpp"
+#include "tlsf_cpp/tlsf_trace_replay.hpp"
+
+TEST(TLSFTrace, record_allocator_calls)
+{
+  tlsf_trace_recorder recorder(16);
+  tlsf_heap_allocator<int> alloc(64 * 1024);
+  alloc.pool->set_trace_recorder(&recorder);
+
+  int * values = alloc.allocate(10);
+  alloc.deallocate(values, 10);
+  alloc.pool->set_trace_recorder(nullptr);
+  alloc.deallocate(alloc.allocate(1), 1);
+
+  auto events = recorder.snapshot();
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(tlsf_trace_event::allocate, events[0].type);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(values), events[0].address);
+  EXPECT_EQ(10 * sizeof(int), events[0].size);
+  EXPECT_EQ(alignof(int), events[0].alignment);
+  EXPECT_EQ(tlsf_trace_event::deallocate, events[1].type);
+  EXPECT_EQ(events[0].address, events[1].address);
+  EXPECT_LE(events[0].timestamp_ns, events[1].timestamp_ns);
+}
+
+TEST(TLSFTrace, ring_keeps_newest_events)
+{
+  tlsf_trace_recorder recorder(4);
+  for (uintptr_t i = 1; i <= 10; ++i) {
+    recorder.record(tlsf_trace_event::allocate, reinterpret_cast<void *>(i), i, 8);
+  }
+  EXPECT_EQ(10u, recorder.recorded());
+  EXPECT_EQ(6u, recorder.overwritten());
+  auto events = recorder.snapshot();
+  ASSERT_EQ(4u, events.size());
+  EXPECT_EQ(7u, events.front().size);
+  EXPECT_EQ(10u, events.back().size);
+}
+
+TEST(TLSFTrace, dump_and_read)
+{
+  tlsf_trace_recorder recorder(8);
+  tlsf_pool pool(8 * 1024);
+  pool.set_trace_recorder(&recorder);
+  void * block = pool.allocate(100, 64);
+  EXPECT_EQ(nullptr, pool.allocate(1024 * 1024));
+  pool.deallocate(block, 100, 64);
+  pool.set_trace_recorder(nullptr);
+
+  std::stringstream text;
+  recorder.dump(text);
+  std::vector<tlsf_trace_event> events;
+  ASSERT_TRUE(tlsf_read_trace(text, events));
+  auto recorded = recorder.snapshot();
+  ASSERT_EQ(recorded.size(), events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(recorded[i].timestamp_ns, events[i].timestamp_ns);
+    EXPECT_EQ(recorded[i].thread, events[i].thread);
+    EXPECT_EQ(recorded[i].type, events[i].type);
+    EXPECT_EQ(recorded[i].address, events[i].address);
+    EXPECT_EQ(recorded[i].size, events[i].size);
+    EXPECT_EQ(recorded[i].alignment, events[i].alignment);
+  }
+  EXPECT_EQ(tlsf_trace_event::failed_allocate, events[1].type);
+
+  std::stringstream garbage("1 2 x 3 4 5\n");
+  EXPECT_FALSE(tlsf_read_trace(garbage, events));
+}
+
+TEST(TLSFTrace, replay)
+{
+  // Record a list growing and shrinking, which leaves holes behind in the pool.
+  tlsf_trace_recorder recorder(4096);
+  tlsf_heap_allocator<int> alloc(256 * 1024);
+  alloc.pool->set_trace_recorder(&recorder);
+  {
+    std::list<int, tlsf_heap_allocator<int>> values(alloc);
+    for (int i = 0; i < 500; ++i) {
+      values.push_back(i);
+      if (i % 3 == 0) {
+        values.pop_front();
+      }
+    }
+  }
+  alloc.pool->set_trace_recorder(nullptr);
+  auto events = recorder.snapshot();
+
+  tlsf_pool large_pool(256 * 1024);
+  auto large = tlsf_replay_trace(events, large_pool, 100);
+  EXPECT_EQ(0u, large.failed_allocation_count);
+  EXPECT_EQ(0u, large.unmatched_deallocation_count);
+  EXPECT_EQ(large.allocation_count, large.deallocation_count);
+  EXPECT_EQ(alloc.pool->stats().peak_bytes_in_use, large.peak_bytes_in_use);
+  EXPECT_GT(large.allocate_latency.count, 0u);
+  ASSERT_FALSE(large.timeline.empty());
+  EXPECT_EQ(events.size() - 1, large.timeline.back().event_index);
+  EXPECT_EQ(0u, large_pool.stats().bytes_in_use);
+
+  auto malloc_result = tlsf_replay_trace(events, *std::pmr::new_delete_resource());
+  EXPECT_EQ(0u, malloc_result.failed_allocation_count);
+  EXPECT_EQ(large.peak_bytes_in_use, malloc_result.peak_bytes_in_use);
+  EXPECT_TRUE(malloc_result.timeline.empty());
+
+  size_t min_size = tlsf_find_min_pool_size(events, 256 * 1024, 256);
+  ASSERT_GT(min_size, large.peak_bytes_in_use);
+  tlsf_pool small_pool(min_size - 1024);
+  EXPECT_GT(tlsf_replay_trace(events, small_pool).failed_allocation_count, 0u);
+  EXPECT_EQ(0u, tlsf_find_min_pool_size(events, large.peak_bytes_in_use / 2));
+}